@@ -0,0 +1,132 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Crowd/CrowdReplicationCell.h"
+
+#include "Net/UnrealNetwork.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CrowdReplicationCell)
+
+FOnCrowdAgentEvent ACrowdReplicationCell::OnAgentAdded;
+FOnCrowdAgentEvent ACrowdReplicationCell::OnAgentChanged;
+FOnCrowdAgentEvent ACrowdReplicationCell::OnAgentRemoved;
+
+void FCrowdAgent::PostReplicatedAdd(const FCrowdAgentArray& InArraySerializer)
+{
+	ACrowdReplicationCell::OnAgentAdded.Broadcast(InArraySerializer.OwnerCell, *this);
+}
+
+void FCrowdAgent::PostReplicatedChange(const FCrowdAgentArray& InArraySerializer)
+{
+	ACrowdReplicationCell::OnAgentChanged.Broadcast(InArraySerializer.OwnerCell, *this);
+}
+
+void FCrowdAgent::PreReplicatedRemove(const FCrowdAgentArray& InArraySerializer)
+{
+	ACrowdReplicationCell::OnAgentRemoved.Broadcast(InArraySerializer.OwnerCell, *this);
+}
+
+ACrowdReplicationCell::ACrowdReplicationCell(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	bReplicates = true;
+	SetReplicatingMovement(false);
+	SetNetUpdateFrequency(10.f);
+
+	// Should cover a cell and a half, so agents on the far side of a neighbouring cell are still received
+	SetNetCullDistanceSquared(FMath::Square(15000.f));
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+	Agents.OwnerCell = this;
+}
+
+void ACrowdReplicationCell::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ACrowdReplicationCell, Agents);
+}
+
+void ACrowdReplicationCell::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The cell left relevancy or got destroyed, its agents go with it
+	if (!HasAuthority())
+	{
+		for (const FCrowdAgent& Agent : Agents.Items)
+		{
+			OnAgentRemoved.Broadcast(this, Agent);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ACrowdReplicationCell::AddAgent(const FCrowdAgent& Agent)
+{
+	AgentIndices.Add(Agent.AgentId, Agents.Items.Num());
+
+	FCrowdAgent& NewAgent = Agents.Items.Add_GetRef(Agent);
+	Agents.MarkItemDirty(NewAgent);
+}
+
+bool ACrowdReplicationCell::UpdateAgent(int32 AgentId, const FVector& Location, float Yaw, uint8 State)
+{
+	const int32* AgentIdx = AgentIndices.Find(AgentId);
+	if (AgentIdx == nullptr)
+	{
+		return false;
+	}
+
+	FCrowdAgent* Agent = &Agents.Items[*AgentIdx];
+
+	// Changes below the replicated precision would only cost bandwidth
+	const uint16 CompressedYaw = FRotator::CompressAxisToShort(Yaw);
+	if (Agent->Location.Equals(Location, 1.f) && Agent->Yaw == CompressedYaw && Agent->State == State)
+	{
+		return true;
+	}
+
+	Agent->Location = Location;
+	Agent->Yaw = CompressedYaw;
+	Agent->State = State;
+	Agents.MarkItemDirty(*Agent);
+	return true;
+}
+
+bool ACrowdReplicationCell::RemoveAgent(int32 AgentId, FCrowdAgent* OutAgent)
+{
+	int32 AgentIdx = INDEX_NONE;
+	if (!AgentIndices.RemoveAndCopyValue(AgentId, AgentIdx))
+	{
+		return false;
+	}
+
+	if (OutAgent)
+	{
+		*OutAgent = Agents.Items[AgentIdx];
+	}
+
+	Agents.Items.RemoveAtSwap(AgentIdx);
+	Agents.MarkArrayDirty();
+
+	// The last agent got swapped into the hole
+	if (Agents.Items.IsValidIndex(AgentIdx))
+	{
+		AgentIndices.FindChecked(Agents.Items[AgentIdx].AgentId) = AgentIdx;
+	}
+	return true;
+}
+
+const FCrowdAgent* ACrowdReplicationCell::FindAgent(int32 AgentId) const
+{
+	if (HasAuthority())
+	{
+		const int32* AgentIdx = AgentIndices.Find(AgentId);
+		return AgentIdx ? &Agents.Items[*AgentIdx] : nullptr;
+	}
+
+	return Agents.Items.FindByPredicate([AgentId](const FCrowdAgent& Item) { return Item.AgentId == AgentId; });
+}
@@ -0,0 +1,253 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Crowd/CrowdReplicationManager.h"
+
+#include "Crowd/CrowdReplicationCell.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "TimerManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CrowdReplicationManager)
+
+ACrowdReplicationManager::ACrowdReplicationManager(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// Only the cells replicate
+	bReplicates = false;
+
+	CellClass = ACrowdReplicationCell::StaticClass();
+}
+
+ACrowdReplicationManager* ACrowdReplicationManager::Get(const UWorld* World)
+{
+	if (World)
+	{
+		for (TActorIterator<ACrowdReplicationManager> It(const_cast<UWorld*>(World)); It; ++It)
+		{
+			return *It;
+		}
+	}
+
+	return nullptr;
+}
+
+void ACrowdReplicationManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (const auto& CellIt : Cells)
+	{
+		if (IsValid(CellIt.Value))
+		{
+			CellIt.Value->Destroy();
+		}
+	}
+
+	Cells.Reset();
+	AgentCells.Reset();
+	EmptyCells.Reset();
+
+	GetWorldTimerManager().ClearTimer(RemoveEmptyCellsTimer);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+int32 ACrowdReplicationManager::AddAgent(const FVector& Location, float Yaw, uint8 State)
+{
+	const FIntPoint CellCoords = GetCellCoords(Location);
+	ACrowdReplicationCell* Cell = FindOrAddCell(CellCoords);
+	if (Cell == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 AgentId = NextAgentId++;
+	Cell->AddAgent(FCrowdAgent(AgentId, Location, Yaw, State));
+	AgentCells.Add(AgentId, CellCoords);
+	return AgentId;
+}
+
+void ACrowdReplicationManager::UpdateAgent(int32 AgentId, const FVector& Location, float Yaw, uint8 State)
+{
+	FIntPoint* CellCoords = AgentCells.Find(AgentId);
+	if (CellCoords == nullptr)
+	{
+		return;
+	}
+
+	const FIntPoint NewCellCoords = GetCellCoords(Location);
+	if (NewCellCoords == *CellCoords)
+	{
+		if (ACrowdReplicationCell* Cell = Cells.FindRef(*CellCoords))
+		{
+			Cell->UpdateAgent(AgentId, Location, Yaw, State);
+		}
+
+		return;
+	}
+
+	// The agent crossed into another cell
+	ACrowdReplicationCell* NewCell = FindOrAddCell(NewCellCoords);
+	if (NewCell == nullptr)
+	{
+		return;
+	}
+
+	if (ACrowdReplicationCell* OldCell = Cells.FindRef(*CellCoords))
+	{
+		OldCell->RemoveAgent(AgentId);
+	}
+
+	ConditionalRemoveCell(*CellCoords);
+
+	NewCell->AddAgent(FCrowdAgent(AgentId, Location, Yaw, State));
+	*CellCoords = NewCellCoords;
+}
+
+void ACrowdReplicationManager::RemoveAgent(int32 AgentId)
+{
+	FIntPoint CellCoords;
+	if (!AgentCells.RemoveAndCopyValue(AgentId, CellCoords))
+	{
+		return;
+	}
+
+	if (ACrowdReplicationCell* Cell = Cells.FindRef(CellCoords))
+	{
+		Cell->RemoveAgent(AgentId);
+	}
+
+	ConditionalRemoveCell(CellCoords);
+}
+
+AActor* ACrowdReplicationManager::PromoteAgent(int32 AgentId, TSubclassOf<AActor> ActorClass)
+{
+	const FCrowdAgent* Agent = FindAgent(AgentId);
+	if (Agent == nullptr || ActorClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	const FTransform SpawnTransform(FRotator(0.f, Agent->GetYaw(), 0.f), Agent->Location);
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(ActorClass, SpawnTransform, SpawnParams);
+	if (Actor)
+	{
+		RemoveAgent(AgentId);
+	}
+
+	return Actor;
+}
+
+int32 ACrowdReplicationManager::DemoteActor(AActor* Actor, uint8 State)
+{
+	if (!IsValid(Actor))
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 AgentId = AddAgent(Actor->GetActorLocation(), Actor->GetActorRotation().Yaw, State);
+	Actor->Destroy();
+	return AgentId;
+}
+
+const FCrowdAgent* ACrowdReplicationManager::FindAgent(int32 AgentId) const
+{
+	if (const FIntPoint* CellCoords = AgentCells.Find(AgentId))
+	{
+		if (const ACrowdReplicationCell* Cell = Cells.FindRef(*CellCoords))
+		{
+			return Cell->FindAgent(AgentId);
+		}
+	}
+
+	return nullptr;
+}
+
+FIntPoint ACrowdReplicationManager::GetCellCoords(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+ACrowdReplicationCell* ACrowdReplicationManager::FindOrAddCell(const FIntPoint& CellCoords)
+{
+	if (ACrowdReplicationCell* Cell = Cells.FindRef(CellCoords))
+	{
+		EmptyCells.Remove(CellCoords);
+		return Cell;
+	}
+
+	// Cells sit at their center, so they're spatialized like the agents in them
+	const FVector CellCenter((CellCoords.X + 0.5f) * CellSize, (CellCoords.Y + 0.5f) * CellSize, GetActorLocation().Z);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = this;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	ACrowdReplicationCell* Cell = GetWorld()->SpawnActor<ACrowdReplicationCell>(CellClass, FTransform(CellCenter), SpawnParams);
+	if (Cell)
+	{
+		Cells.Add(CellCoords, Cell);
+	}
+
+	return Cell;
+}
+
+void ACrowdReplicationManager::ConditionalRemoveCell(const FIntPoint& CellCoords)
+{
+	ACrowdReplicationCell* Cell = Cells.FindRef(CellCoords);
+	if (Cell == nullptr || Cell->GetNumAgents() > 0)
+	{
+		return;
+	}
+
+	if (EmptyCellLifetime <= 0.f)
+	{
+		Cells.Remove(CellCoords);
+		Cell->Destroy();
+		return;
+	}
+
+	EmptyCells.Add(CellCoords, GetWorld()->GetTimeSeconds());
+
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	if (!TimerManager.IsTimerActive(RemoveEmptyCellsTimer))
+	{
+		TimerManager.SetTimer(RemoveEmptyCellsTimer, this, &ThisClass::RemoveEmptyCells, EmptyCellLifetime, false);
+	}
+}
+
+void ACrowdReplicationManager::RemoveEmptyCells()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	double NextRemoveTime = TNumericLimits<double>::Max();
+
+	for (auto It = EmptyCells.CreateIterator(); It; ++It)
+	{
+		ACrowdReplicationCell* Cell = Cells.FindRef(It.Key());
+		if (Cell == nullptr || Cell->GetNumAgents() > 0)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		const double RemoveTime = It.Value() + EmptyCellLifetime;
+		if (RemoveTime > Now)
+		{
+			NextRemoveTime = FMath::Min(NextRemoveTime, RemoveTime);
+			continue;
+		}
+
+		Cells.Remove(It.Key());
+		Cell->Destroy();
+		It.RemoveCurrent();
+	}
+
+	if (EmptyCells.Num() > 0)
+	{
+		GetWorldTimerManager().SetTimer(RemoveEmptyCellsTimer, this, &ThisClass::RemoveEmptyCells, (float)FMath::Max(NextRemoveTime - Now, 0.1), false);
+	}
+}
@@ -0,0 +1,113 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "GameplayReplayReplicationGraph.h"
+
+#include "Nodes/GameRepGraphNode_AlwaysRelevant_ForConnection.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(GameplayReplayReplicationGraph)
+
+namespace GameplayRepGraph
+{
+	/** How many buckets the replay graph spreads recorded actors across. */
+	int32 ReplayFrequencyBuckets = 4;
+	static FAutoConsoleVariableRef CVarGameRepGraph_ReplayFrequencyBuckets(TEXT("GameRepGraph.Replay.FrequencyBuckets"), ReplayFrequencyBuckets, TEXT("How many buckets the replay graph spreads recorded actors across. Each actor is recorded every N frames."), ECVF_Default);
+
+	/** How long recording a replay frame may take on average. */
+	float ReplayMaxRecordMs = 1.f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_ReplayMaxRecordMs(TEXT("GameRepGraph.Replay.MaxRecordMs"), ReplayMaxRecordMs, TEXT("How long recording a replay frame may take on average in ms. Longer frames are paid back by skipping the following ones. 0 = unbounded."), ECVF_Default);
+
+	/** The most recording frames skipped in a row. */
+	int32 ReplayMaxSkippedFrames = 4;
+	static FAutoConsoleVariableRef CVarGameRepGraph_ReplayMaxSkippedFrames(TEXT("GameRepGraph.Replay.MaxSkippedFrames"), ReplayMaxSkippedFrames, TEXT("The most recording frames skipped in a row to pay back a long one."), ECVF_Default);
+}
+
+void UGameplayReplayReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// Recording isn't bandwidth bound and skips whole frames instead, replays keep the class' replication periods
+	bAdaptiveFrequencies = false;
+
+	// The recorder sees every destruction
+	DestructInfoMaxDistanceSquared = TNumericLimits<float>::Max();
+}
+
+void UGameplayReplayReplicationGraph::InitGlobalGraphNodes()
+{
+	Super::InitGlobalGraphNodes();
+
+	// ----------------------------------------------------------------------------------------------------------------
+	//	Recorded Actors
+	//	Everything that is spatialized or published to interest groups in the game graph.
+	// ----------------------------------------------------------------------------------------------------------------
+	ReplayActorsNode = CreateNewNode<UReplicationGraphNode_ActorListFrequencyBuckets>();
+	ReplayActorsNode->SetNonStreamingCollectionSize(FMath::Max(GameplayRepGraph::ReplayFrequencyBuckets, 1));
+	AddGlobalGraphNode(ReplayActorsNode);
+}
+
+void UGameplayReplayReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* ConnectionManager)
+{
+	// No owner-only or policy nodes, the recorder doesn't own anything and has no view to apply policies to
+	UReplicationGraph::InitConnectionGraphNodes(ConnectionManager);
+
+	UGameRepGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = CreateNewNode<UGameRepGraphNode_AlwaysRelevant_ForConnection>();
+
+	// This node needs to know when client levels go in and out of visibility
+	ConnectionManager->OnClientVisibleLevelNameAdd.AddUObject(AlwaysRelevantConnectionNode, &UGameRepGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd);
+	ConnectionManager->OnClientVisibleLevelNameRemove.AddUObject(AlwaysRelevantConnectionNode, &UGameRepGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
+
+	AddConnectionGraphNode(AlwaysRelevantConnectionNode, ConnectionManager);
+}
+
+void UGameplayReplayReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	if (IsRecordedByReplayNode(GetMappingPolicy(ActorInfo.Class)))
+	{
+		ReplayActorsNode->NotifyAddNetworkActor(ActorInfo);
+		return;
+	}
+
+	Super::RouteAddNetworkActorToNodes(ActorInfo, GlobalInfo);
+}
+
+void UGameplayReplayReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	if (IsRecordedByReplayNode(GetMappingPolicy(ActorInfo.Class)))
+	{
+		InterestGroupNode->NotifyRemoveNetworkActor(ActorInfo, false);
+		ReplayActorsNode->NotifyRemoveNetworkActor(ActorInfo);
+		return;
+	}
+
+	Super::RouteRemoveNetworkActorToNodes(ActorInfo);
+}
+
+int32 UGameplayReplayReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	if (NumFramesToSkip > 0)
+	{
+		--NumFramesToSkip;
+		return 0;
+	}
+
+	// No governor or join ramp here, recording bounds its cost by skipping frames instead
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumReplicated = UReplicationGraph::ServerReplicateActors(DeltaSeconds);
+	const double RecordMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	if (GameplayRepGraph::ReplayMaxRecordMs > 0.f)
+	{
+		// A frame taking N times the budget skips the next N-1 frames, keeping the average within the budget
+		const int32 NumOverBudget = FMath::CeilToInt(RecordMs / GameplayRepGraph::ReplayMaxRecordMs) - 1;
+		NumFramesToSkip = FMath::Clamp(NumOverBudget, 0, FMath::Max(GameplayRepGraph::ReplayMaxSkippedFrames, 0));
+	}
+
+	return NumReplicated;
+}
+
+void UGameplayReplayReplicationGraph::InflateClassCullDistance(UClass* Class, FClassReplicationInfo& Info)
+{
+	// Without a cull distance, recorded actors are never distance culled for the recorder
+	Info.SetCullDistanceSquared(0.f);
+}
@@ -4,6 +4,8 @@
 #include "GameplayReplicationGraph.h"
 
 #include "EngineUtils.h"
+#include "GameplayReplayReplicationGraph.h"
+#include "GameplayReplicationGraphConnection.h"
 #include "GameplayReplicationGraphSettings.h"
 #include "GameplayReplicationGraphTypes.h"
 #include "Engine/ServerStatReplicator.h"
@@ -12,15 +14,25 @@
 #include "GameFramework/GameState.h"
 #include "GameFramework/PlayerState.h"
 #include "GameFramework/Pawn.h"
+#include "Engine/Level.h"
 #include "Engine/LevelScriptActor.h"
 #include "Engine/NetConnection.h"
+#include "Engine/ChildConnection.h"
+#include "Engine/DemoNetDriver.h"
+#include "Net/RepLayout.h"
 #include "GameFramework/Character.h"
 #include "UObject/UObjectIterator.h"
 
 
 
+#include "Nodes/GameRepGraphNode_ActorPolicy_ForConnection.h"
 #include "Nodes/GameRepGraphNode_AlwaysRelevant_ForConnection.h"
+#include "Nodes/GameRepGraphNode_GridSpatialization2D.h"
+#include "Nodes/GameRepGraphNode_OwnerOnly_ForConnection.h"
+#include "Nodes/GameRepGraphNode_InterestGroups.h"
 #include "Nodes/GameRepGraphNode_PlayerStateFrequencyLimiter.h"
+#include "Nodes/GameRepGraphNode_ProjectileEvents.h"
+#include "Projectiles/ProjectileEventComponent.h"
 
 #if WITH_GAMEPLAY_DEBUGGER
 #include "GameplayDebuggerCategoryReplicator.h"
@@ -66,14 +78,171 @@ namespace GameplayRepGraph
 	int32 DisableSpatialRebuilds = 1;
 	static FAutoConsoleVariableRef CVarGameRepGraph_DisableSpatialRebuilds(TEXT("GameRepGraph.DisableSpatialRebuilds"), DisableSpatialRebuilds, TEXT("Whether to disable spatial rebuilds."), ECVF_Default);
 
+	/** How many frames the spatial grid spreads full gathers of connections across. 1 = every connection every frame. */
+	int32 GatherTimeSlices = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_GatherTimeSlices(TEXT("GameRepGraph.GatherTimeSlices"), GatherTimeSlices, TEXT("How many frames the spatial grid spreads full gathers of connections across. 1 = every connection every frame. In between, connections only get their cached spatial actors for the FastShared path."), ECVF_Default);
+
+	/** Whether connections with the same viewer and visible levels should share one spatial gather per frame. */
+	int32 EnableSharedGather = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnableSharedGather(TEXT("GameRepGraph.SharedGather.Enable"), EnableSharedGather, TEXT("Whether connections with the same viewer and visible levels (e.g. spectators of the same player) should share one spatial gather per frame."), ECVF_Default);
+
+	/** How close two viewers need to be to share a gather. */
+	float SharedGatherLocationQuantize = 100.f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_SharedGatherLocationQuantize(TEXT("GameRepGraph.SharedGather.LocationQuantize"), SharedGatherLocationQuantize, TEXT("Size of the cells viewer locations are snapped to when grouping connections into cohorts."), ECVF_Default);
+
+	/** How often every cohort member runs its own gather. */
+	int32 SharedGatherRefreshFrames = 30;
+	static FAutoConsoleVariableRef CVarGameRepGraph_SharedGatherRefreshFrames(TEXT("GameRepGraph.SharedGather.RefreshFrames"), SharedGatherRefreshFrames, TEXT("How often (in frames) every cohort member runs its own gather, so its per-connection dormancy state catches up."), ECVF_Default);
+
 	/** Whether to display client level streaming. */
 	int32 DisplayClientLevelStreaming = 0;
 	static FAutoConsoleVariableRef CVarGameRepGraph_DisplayClientLevelStreaming(TEXT("GameRepGraph.DisplayClientLevelStreaming"), DisplayClientLevelStreaming, TEXT("Whether to display client level streaming."), ECVF_Default);
 
+	/** Whether classes with bEnableOcclusionCulling should replicate less often to viewers they're hidden from. */
+	int32 EnableOcclusionCulling = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnableOcclusionCulling(TEXT("GameRepGraph.Occlusion.Enable"), EnableOcclusionCulling, TEXT("Whether classes with bEnableOcclusionCulling should replicate less often to viewers they're hidden from."), ECVF_Default);
+
+	/** How many frames an occlusion result is reused before the actor is traced again. */
+	int32 OcclusionCacheFrames = 10;
+	static FAutoConsoleVariableRef CVarGameRepGraph_OcclusionCacheFrames(TEXT("GameRepGraph.Occlusion.CacheFrames"), OcclusionCacheFrames, TEXT("How many frames an occlusion result is reused before the actor is traced again."), ECVF_Default);
+
+	/** The maximum number of occlusion traces started per connection per frame. */
+	int32 OcclusionMaxTracesPerFrame = 16;
+	static FAutoConsoleVariableRef CVarGameRepGraph_OcclusionMaxTracesPerFrame(TEXT("GameRepGraph.Occlusion.MaxTracesPerFrame"), OcclusionMaxTracesPerFrame, TEXT("The maximum number of occlusion traces started per connection per frame."), ECVF_Default);
+
+	/** Actors closer than this to the viewer are never considered occluded. */
+	float OcclusionMinDistance = 1500.f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_OcclusionMinDistance(TEXT("GameRepGraph.Occlusion.MinDistance"), OcclusionMinDistance, TEXT("Actors closer than this to the viewer are never considered occluded."), ECVF_Default);
+
+	/** How many occluded results in a row are needed before an actor is treated as occluded. */
+	int32 OcclusionResultsRequired = 2;
+	static FAutoConsoleVariableRef CVarGameRepGraph_OcclusionResultsRequired(TEXT("GameRepGraph.Occlusion.ResultsRequired"), OcclusionResultsRequired, TEXT("How many occluded results in a row are needed before an actor is treated as occluded. A visible result applies right away."), ECVF_Default);
+
+	/** Whether classes with bEnableViewCone should replicate less often while they're outside of the viewer's view cone. */
+	int32 EnableViewCone = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnableViewCone(TEXT("GameRepGraph.ViewCone.Enable"), EnableViewCone, TEXT("Whether classes with bEnableViewCone should replicate less often while they're outside of the viewer's view cone."), ECVF_Default);
+
+	/** Actors closer than this to the viewer are always treated as being inside the view cone. */
+	float ViewConeMinDistance = 1000.f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_ViewConeMinDistance(TEXT("GameRepGraph.ViewCone.MinDistance"), ViewConeMinDistance, TEXT("Actors closer than this to the viewer are always treated as being inside the view cone."), ECVF_Default);
+
+	/** Whether classes with distance bands should replicate at the rate of the band they're in. */
+	int32 EnableDistanceBands = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnableDistanceBands(TEXT("GameRepGraph.DistanceBands.Enable"), EnableDistanceBands, TEXT("Whether classes with distance bands should replicate at the rate of the band they're in."), ECVF_Default);
+
+	/** Whether classes with LOD tiers should reduce the full property and FastShared rates of distant actors. */
+	int32 EnableLODTiers = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnableLODTiers(TEXT("GameRepGraph.LOD.Enable"), EnableLODTiers, TEXT("Whether classes with LOD tiers should reduce the full property and FastShared rates of distant actors."), ECVF_Default);
+
+	/** Whether classes with bEnablePredictiveRelevancy should start replicating early when they're about to enter a viewer's cull distance. */
+	int32 EnablePredictiveRelevancy = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnablePredictiveRelevancy(TEXT("GameRepGraph.Predictive.Enable"), EnablePredictiveRelevancy, TEXT("Whether classes with bEnablePredictiveRelevancy should start replicating early when they're about to enter a viewer's cull distance."), ECVF_Default);
+
+	/** How many new actor channels a connection may open per frame. 0 = unlimited. */
+	int32 MaxChannelOpensPerFrame = 0;
+	static FAutoConsoleVariableRef CVarGameRepGraph_MaxChannelOpensPerFrame(TEXT("GameRepGraph.MaxChannelOpensPerFrame"), MaxChannelOpensPerFrame, TEXT("How many new actor channels a connection may open per frame. 0 = unlimited. The rest is deferred to the following frames, ordered by NetPriority and distance."), ECVF_Default);
+
+	/** Whether joining connections should get their actors in stages, essentials and nearby actors first. */
+	int32 EnableJoinStaging = 0;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnableJoinStaging(TEXT("GameRepGraph.Join.Enable"), EnableJoinStaging, TEXT("Whether joining connections should get their actors in stages, essentials and nearby actors first."), ECVF_Default);
+
+	/** How many frames after joining a connection ramps up to its full set of actors. */
+	int32 JoinRampFrames = 90;
+	static FAutoConsoleVariableRef CVarGameRepGraph_JoinRampFrames(TEXT("GameRepGraph.Join.RampFrames"), JoinRampFrames, TEXT("How many frames after joining a connection ramps up to its full set of actors."), ECVF_Default);
+
+	/** Actors within this distance are sent to joining connections right away. */
+	float JoinNearDistance = 5000.f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_JoinNearDistance(TEXT("GameRepGraph.Join.NearDistance"), JoinNearDistance, TEXT("Actors within this distance are sent to joining connections right away. The distance grows to unlimited over the ramp."), ECVF_Default);
+
+	/** How many actor channels all joining connections together may open per frame. */
+	int32 JoinMaxChannelOpensPerFrame = 30;
+	static FAutoConsoleVariableRef CVarGameRepGraph_JoinMaxChannelOpensPerFrame(TEXT("GameRepGraph.Join.MaxChannelOpensPerFrame"), JoinMaxChannelOpensPerFrame, TEXT("How many actor channels all joining connections together may open per frame. 0 = only the per-connection limit applies."), ECVF_Default);
+
+	/** Whether classes with MaxActorsPerFrame should be limited to that many actors per connection per frame. */
+	int32 EnableClassBudgets = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnableClassBudgets(TEXT("GameRepGraph.ClassBudgets.Enable"), EnableClassBudgets, TEXT("Whether classes with MaxActorsPerFrame should be limited to that many actors per connection per frame."), ECVF_Default);
+
+	/** Whether classes with bReplicateOnlyWhenDirty should skip actors that haven't been marked dirty since they last replicated. */
+	int32 SkipCleanActors = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_SkipCleanActors(TEXT("GameRepGraph.SkipCleanActors"), SkipCleanActors, TEXT("Whether classes with bReplicateOnlyWhenDirty should skip actors that haven't been marked dirty since they last replicated."), ECVF_Default);
+
+	/** Whether classes with bEnableAdaptiveFrequency should adapt the replication period of their actors to how often they change. */
+	int32 EnableAdaptiveFrequency = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnableAdaptiveFrequency(TEXT("GameRepGraph.Adaptive.Enable"), EnableAdaptiveFrequency, TEXT("Whether classes with bEnableAdaptiveFrequency should adapt the replication period of their actors to how often they change."), ECVF_Default);
+
+	/** How many frames the adaptive frequency observes actors for before adjusting. */
+	int32 AdaptiveIntervalFrames = 60;
+	static FAutoConsoleVariableRef CVarGameRepGraph_AdaptiveIntervalFrames(TEXT("GameRepGraph.Adaptive.IntervalFrames"), AdaptiveIntervalFrames, TEXT("How many frames the adaptive frequency observes actors for before adjusting their replication period."), ECVF_Default);
+
+	/** Actors changing at most this often get their replication period doubled. */
+	float AdaptiveLowChangePct = 0.25f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_AdaptiveLowChangePct(TEXT("GameRepGraph.Adaptive.LowChangePct"), AdaptiveLowChangePct, TEXT("Actors whose replications carried changed data at most this often get their replication period doubled."), ECVF_Default);
+
+	/** Actors changing at least this often get their replication period halved. */
+	float AdaptiveHighChangePct = 0.9f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_AdaptiveHighChangePct(TEXT("GameRepGraph.Adaptive.HighChangePct"), AdaptiveHighChangePct, TEXT("Actors whose replications carried changed data at least this often get their replication period halved."), ECVF_Default);
+
+	/** Whether classes with bShrinkCullDistanceWhenSaturated should get a shorter cull distance on saturated connections. */
+	int32 EnableSaturationCullDistance = 1;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnableSaturationCullDistance(TEXT("GameRepGraph.Saturation.Enable"), EnableSaturationCullDistance, TEXT("Whether classes with bShrinkCullDistanceWhenSaturated should get a shorter cull distance on saturated connections."), ECVF_Default);
+
+	/** The smallest scale the cull distance of saturated connections shrinks down to. */
+	float SaturationMinCullDistanceScale = 0.5f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_SaturationMinCullDistanceScale(TEXT("GameRepGraph.Saturation.MinCullDistanceScale"), SaturationMinCullDistanceScale, TEXT("The smallest scale the cull distance of saturated connections shrinks down to."), ECVF_Default);
+
+	/** How much the cull distance scale changes per step. */
+	float SaturationStepScale = 0.1f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_SaturationStepScale(TEXT("GameRepGraph.Saturation.StepScale"), SaturationStepScale, TEXT("How much the cull distance scale changes per step."), ECVF_Default);
+
+	/** How many frames in a row a connection needs to be saturated before its cull distance shrinks another step. */
+	int32 SaturationShrinkFrames = 4;
+	static FAutoConsoleVariableRef CVarGameRepGraph_SaturationShrinkFrames(TEXT("GameRepGraph.Saturation.ShrinkFrames"), SaturationShrinkFrames, TEXT("How many frames in a row a connection needs to be saturated before its cull distance shrinks another step."), ECVF_Default);
+
+	/** How many frames in a row a connection needs to be clear before its cull distance recovers a step. */
+	int32 SaturationRecoverFrames = 30;
+	static FAutoConsoleVariableRef CVarGameRepGraph_SaturationRecoverFrames(TEXT("GameRepGraph.Saturation.RecoverFrames"), SaturationRecoverFrames, TEXT("How many frames in a row a connection needs to be clear before its cull distance recovers a step."), ECVF_Default);
+
+	/** The most projectile events sent to a connection in a single RPC. */
+	int32 ProjectileMaxEventsPerBatch = 32;
+	static FAutoConsoleVariableRef CVarGameRepGraph_ProjectileMaxEventsPerBatch(TEXT("GameRepGraph.Projectiles.MaxEventsPerBatch"), ProjectileMaxEventsPerBatch, TEXT("The most projectile events sent to a connection in a single RPC. Larger batches are split across multiple RPCs."), ECVF_Default);
+
+	/** Whether the replication graph should scale its work down while it takes longer than the target frame time. */
+	int32 EnableGovernor = 0;
+	static FAutoConsoleVariableRef CVarGameRepGraph_EnableGovernor(TEXT("GameRepGraph.Governor.Enable"), EnableGovernor, TEXT("Whether the replication graph should scale its work down while it takes longer than the target frame time."), ECVF_Default);
+
+	/** How long replicating actors may take per frame, averaged over the adjust interval. */
+	float GovernorTargetMs = 4.f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_GovernorTargetMs(TEXT("GameRepGraph.Governor.TargetMs"), GovernorTargetMs, TEXT("How long replicating actors may take per frame in ms, averaged over the adjust interval."), ECVF_Default);
+
+	/** How many frames the governor averages over before adjusting. */
+	int32 GovernorAdjustIntervalFrames = 30;
+	static FAutoConsoleVariableRef CVarGameRepGraph_GovernorAdjustIntervalFrames(TEXT("GameRepGraph.Governor.AdjustIntervalFrames"), GovernorAdjustIntervalFrames, TEXT("How many frames the governor averages over before adjusting."), ECVF_Default);
+
+	/** How many levels the governor may step down in. */
+	int32 GovernorMaxLevel = 4;
+	static FAutoConsoleVariableRef CVarGameRepGraph_GovernorMaxLevel(TEXT("GameRepGraph.Governor.MaxLevel"), GovernorMaxLevel, TEXT("How many levels the governor may step down in. Its bounds are reached at the last level."), ECVF_Default);
+
+	/** The governor steps back up once the average frame time is below this percentage of the target. */
+	float GovernorRecoveryPct = 0.75f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_GovernorRecoveryPct(TEXT("GameRepGraph.Governor.RecoveryPct"), GovernorRecoveryPct, TEXT("The governor steps back up once the average frame time is below this percentage of the target."), ECVF_Default);
+
+	/** The most dynamic actor frequency buckets the governor may use. */
+	int32 GovernorMaxFrequencyBuckets = 6;
+	static FAutoConsoleVariableRef CVarGameRepGraph_GovernorMaxFrequencyBuckets(TEXT("GameRepGraph.Governor.MaxFrequencyBuckets"), GovernorMaxFrequencyBuckets, TEXT("The most dynamic actor frequency buckets the governor may use."), ECVF_Default);
+
+	/** The most the governor may scale distance band periods by. */
+	float GovernorMaxPeriodScale = 2.f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_GovernorMaxPeriodScale(TEXT("GameRepGraph.Governor.MaxPeriodScale"), GovernorMaxPeriodScale, TEXT("The most the governor may scale distance band periods by."), ECVF_Default);
+
+	/** The lowest percentage of the FastShared bandwidth budget the governor may go down to. */
+	float GovernorMinFastSharedPct = 0.5f;
+	static FAutoConsoleVariableRef CVarGameRepGraph_GovernorMinFastSharedPct(TEXT("GameRepGraph.Governor.MinFastSharedPct"), GovernorMinFastSharedPct, TEXT("The lowest percentage of the FastShared bandwidth budget the governor may go down to."), ECVF_Default);
+
 	UReplicationDriver* ConditionalCreateReplicationDriver(const UNetDriver* ForNetDriver, const UWorld* World)
 	{
-		// Only create a replication driver for the GameNetDriver
-		if (World && ForNetDriver && ForNetDriver->NetDriverName == NAME_GameNetDriver)
+		// Only create a replication driver for the GameNetDriver and replay recording net drivers
+		const bool bIsReplayNetDriver = ForNetDriver && ForNetDriver->IsA<UDemoNetDriver>();
+		if (World && ForNetDriver && (ForNetDriver->NetDriverName == NAME_GameNetDriver || bIsReplayNetDriver))
 		{
 			const UGameplayReplicationGraphSettings* GameRepGraphSettings = UGameplayReplicationGraphSettings::Get();
 
@@ -84,14 +253,22 @@ namespace GameplayRepGraph
 				return nullptr;
 			}
 
+			if (bIsReplayNetDriver && GameRepGraphSettings && !GameRepGraphSettings->bEnableReplayReplicationGraph)
+			{
+				UE_LOG(LogGameRepGraph, Display, TEXT("Replay replication graph is disabled via GameplayReplicationGraphSettings."));
+				return nullptr;
+			}
+
 			UE_LOG(LogGameRepGraph, Display, TEXT("Replication graph is enabled for %s in world %s."), *GetNameSafe(ForNetDriver), *GetPathNameSafe(World));
 
 			// Load the replication graph class
-			TSubclassOf<UGameplayReplicationGraph> GraphClass = GameRepGraphSettings->DefaultReplicationGraphClass.TryLoadClass<UGameplayReplicationGraph>();
+			TSubclassOf<UGameplayReplicationGraph> GraphClass = bIsReplayNetDriver
+				? GameRepGraphSettings->ReplayReplicationGraphClass.TryLoadClass<UGameplayReplicationGraph>()
+				: GameRepGraphSettings->DefaultReplicationGraphClass.TryLoadClass<UGameplayReplicationGraph>();
 			if (GraphClass.Get() == nullptr)
 			{
 				// Use the default replication graph class as a fallback
-				GraphClass = UGameplayReplicationGraph::StaticClass();
+				GraphClass = bIsReplayNetDriver ? UGameplayReplayReplicationGraph::StaticClass() : UGameplayReplicationGraph::StaticClass();
 			}
 
 			UGameplayReplicationGraph* RepGraph = NewObject<UGameplayReplicationGraph>(GetTransientPackage(), GraphClass.Get());
@@ -116,11 +293,29 @@ UGameplayReplicationGraph::UGameplayReplicationGraph()
 			return GameplayRepGraph::ConditionalCreateReplicationDriver(ForNetDriver, World);
 		});
 	}
+
+	ReplicationConnectionManagerClass = UGameplayReplicationGraphConnection::StaticClass();
 }
 
 void UGameplayReplicationGraph::ResetGameWorldState()
 {
 	AlwaysRelevantStreamingLevelActors.Empty();
+	RemovedStreamingLevels.Empty();
+	OwnerOnlyActors.Empty();
+	DependentActors.Empty();
+	ActorDirtyFrames.Empty();
+	AdaptiveActors.Empty();
+	DeactivatedPooledActors.Empty();
+
+	if (InterestGroupNode)
+	{
+		InterestGroupNode->NotifyResetAllNetworkActors();
+	}
+
+	if (ProjectileEventNode)
+	{
+		ProjectileEventNode->NotifyResetAllNetworkActors();
+	}
 
 	// Managed by the connection managers
 	for (const UNetReplicationGraphConnection* Connection : Connections)
@@ -131,6 +326,14 @@ void UGameplayReplicationGraph::ResetGameWorldState()
 			{
 				ThisAlwaysRelevantNode->ResetGameWorldState();
 			}
+			else if (UGameRepGraphNode_OwnerOnly_ForConnection* ThisOwnerOnlyNode = Cast<UGameRepGraphNode_OwnerOnly_ForConnection>(ConnectionNode))
+			{
+				ThisOwnerOnlyNode->NotifyResetAllNetworkActors();
+			}
+			else if (UGameRepGraphNode_ActorPolicy_ForConnection* ThisActorPolicyNode = Cast<UGameRepGraphNode_ActorPolicy_ForConnection>(ConnectionNode))
+			{
+				ThisActorPolicyNode->NotifyResetAllNetworkActors();
+			}
 		}
 	}
 
@@ -142,6 +345,14 @@ void UGameplayReplicationGraph::ResetGameWorldState()
 			{
 				ThisAlwaysRelevantNode->ResetGameWorldState();
 			}
+			else if (UGameRepGraphNode_OwnerOnly_ForConnection* ThisOwnerOnlyNode = Cast<UGameRepGraphNode_OwnerOnly_ForConnection>(ConnectionNode))
+			{
+				ThisOwnerOnlyNode->NotifyResetAllNetworkActors();
+			}
+			else if (UGameRepGraphNode_ActorPolicy_ForConnection* ThisActorPolicyNode = Cast<UGameRepGraphNode_ActorPolicy_ForConnection>(ConnectionNode))
+			{
+				ThisActorPolicyNode->NotifyResetAllNetworkActors();
+			}
 		}
 	}
 }
@@ -197,6 +408,23 @@ void UGameplayReplicationGraph::InitGlobalActorClassSettings()
 	const UGameplayReplicationGraphSettings* GameRepGraphSettings = UGameplayReplicationGraphSettings::Get();
 	check(GameRepGraphSettings);
 
+	// Set up the per-class replication policies. Every class resolves to at least the (empty) AActor policy.
+	ClassPolicies.Set(AActor::StaticClass(), FRepGraphClassPolicy());
+	NumClassBudgets = 0;
+	for (const FRepGraphActorClassSettings& ActorClassSetting : GameRepGraphSettings->ClassSettings)
+	{
+		if (UClass* StaticActorClass = ActorClassSetting.GetStaticActorClass())
+		{
+			FRepGraphClassPolicy ClassPolicy(ActorClassSetting);
+			if (ClassPolicy.MaxActorsPerFrame > 0)
+			{
+				ClassPolicy.BudgetIndex = NumClassBudgets++;
+			}
+
+			ClassPolicies.Set(StaticActorClass, ClassPolicy);
+		}
+	}
+
 	// Set up the class settings and node mappings
 	for (const FRepGraphActorClassSettings& ActorClassSetting : GameRepGraphSettings->ClassSettings)
 	{
@@ -208,6 +436,29 @@ void UGameplayReplicationGraph::InitGlobalActorClassSettings()
 					*StaticActorClass->GetName(), int(ActorClassSetting.ClassNodeMapping));
 
 				AddClassRepInfo(StaticActorClass, ActorClassSetting.ClassNodeMapping);
+
+				if (ActorClassSetting.ClassNodeMapping == EClassRepNodeMapping::RelevantInterestGroup)
+				{
+					if (!ActorClassSetting.InterestGroup.IsNone())
+					{
+						ClassInterestGroups.Set(StaticActorClass, ActorClassSetting.InterestGroup);
+					}
+					else
+					{
+						UE_LOG(LogGameRepGraph, Warning, TEXT("%s is routed to RelevantInterestGroup without an InterestGroup, its actors won't replicate until gameplay code publishes them (AddActorToInterestGroup)."),
+							*StaticActorClass->GetName());
+					}
+				}
+			}
+		}
+
+		// Pooled actors spend most of their life dormant, they belong in the static grid while they are
+		if (ActorClassSetting.bPooledActors)
+		{
+			UClass* StaticActorClass = ActorClassSetting.GetStaticActorClass();
+			if (StaticActorClass && IsSpatialized(GetClassNodeMapping(StaticActorClass)))
+			{
+				AddClassRepInfo(StaticActorClass, EClassRepNodeMapping::Spatialize_Dormancy);
 			}
 		}
 	}
@@ -251,7 +502,10 @@ void UGameplayReplicationGraph::InitGlobalActorClassSettings()
 
 	auto SetClassInfo = [&](UClass* Class, const FClassReplicationInfo& Info)
 	{
-		GlobalActorReplicationInfoMap.SetClassInfo(Class, Info);
+		FClassReplicationInfo InflatedInfo = Info;
+		InflateClassCullDistance(Class, InflatedInfo);
+
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, InflatedInfo);
 		ExplicitlySetClasses.Add(Class);
 	};
 	ExplicitlySetClasses.Reset();
@@ -285,15 +539,17 @@ void UGameplayReplicationGraph::InitGlobalActorClassSettings()
 
 	FastSharedPathConstants.MaxBitsPerFrame = (int32)((float)(GameplayRepGraph::TargetKBytesSecFastSharedPath * 1024 * 8) / NetDriver->GetNetServerMaxTickRate());
 	FastSharedPathConstants.DistanceRequirementPct = GameplayRepGraph::FastSharedPathCullDistPct;
+	BaseFastSharedMaxBitsPerFrame = FastSharedPathConstants.MaxBitsPerFrame;
 
 	SetClassInfo(GameRepGraphSettings->BasePawnClass, CharacterClassRepInfo);
 
 	// ---------------------------------------------------------------------
-	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.ListSize = 12;
-	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.NumBuckets = GameplayRepGraph::DynamicActorFrequencyBuckets;
-	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.BucketThresholds.Reset();
-	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.EnableFastPath = (GameplayRepGraph::EnableFastSharedPath > 0);
-	UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.FastPathFrameModulo = 1;
+	// Our own settings instance, the static DefaultSettings are shared with every other graph in the process (replays, PIE servers)
+	DynamicBucketSettings.ListSize = 12;
+	DynamicBucketSettings.NumBuckets = GameplayRepGraph::DynamicActorFrequencyBuckets;
+	DynamicBucketSettings.BucketThresholds.Reset();
+	DynamicBucketSettings.EnableFastPath = (GameplayRepGraph::EnableFastSharedPath > 0);
+	DynamicBucketSettings.FastPathFrameModulo = 1;
 
 	RPCSendPolicyMap.Reset();
 
@@ -376,7 +632,22 @@ void UGameplayReplicationGraph::InitGlobalGraphNodes()
 	// ----------------------------------------------------------------------------------------------------------------
 	//	Spatial Actors
 	// ----------------------------------------------------------------------------------------------------------------
-	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode = CreateNewNode<UGameRepGraphNode_GridSpatialization2D>();
+
+	// Dynamic actors of each cell use our bucket settings, the governor resizes them through DynamicBucketNodes
+	GridNode->CreateCellNodeOverride = [this](UReplicationGraphNode_GridSpatialization2D* Parent) -> UReplicationGraphNode_GridCell*
+	{
+		UReplicationGraphNode_GridCell* CellNode = Parent->CreateChildNode<UReplicationGraphNode_GridCell>();
+		CellNode->CreateDynamicNodeOverride = [this](UReplicationGraphNode_GridCell* Cell) -> UReplicationGraphNode*
+		{
+			UReplicationGraphNode_ActorListFrequencyBuckets* BucketNode = Cell->CreateChildNode<UReplicationGraphNode_ActorListFrequencyBuckets>();
+			BucketNode->Settings = &DynamicBucketSettings;
+			BucketNode->SetNonStreamingCollectionSize(DynamicBucketSettings.NumBuckets);
+			DynamicBucketNodes.Add(BucketNode);
+			return BucketNode;
+		};
+		return CellNode;
+	};
 	GridNode->CellSize = GameplayRepGraph::SpatialGridCellSize;
 	GridNode->SpatialBias = FVector2D(GameplayRepGraph::SpatialBiasX, GameplayRepGraph::SpatialBiasY);
 
@@ -400,6 +671,20 @@ void UGameplayReplicationGraph::InitGlobalGraphNodes()
 	// ----------------------------------------------------------------------------------------------------------------
 	UGameRepGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = CreateNewNode<UGameRepGraphNode_PlayerStateFrequencyLimiter>();
 	AddGlobalGraphNode(PlayerStateNode);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	//	Interest Groups (teams, squads, parties, ...)
+	//	Actors published to a group are relevant to every connection subscribed to that group.
+	// ----------------------------------------------------------------------------------------------------------------
+	InterestGroupNode = CreateNewNode<UGameRepGraphNode_InterestGroups>();
+	AddGlobalGraphNode(InterestGroupNode);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	//	Event Replicated Projectiles
+	//	Sent to nearby connections as spawn and impact events, without ever opening a channel.
+	// ----------------------------------------------------------------------------------------------------------------
+	ProjectileEventNode = CreateNewNode<UGameRepGraphNode_ProjectileEvents>();
+	AddGlobalGraphNode(ProjectileEventNode);
 }
 
 void UGameplayReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* ConnectionManager)
@@ -413,11 +698,25 @@ void UGameplayReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphCon
 	ConnectionManager->OnClientVisibleLevelNameRemove.AddUObject(AlwaysRelevantConnectionNode, &UGameRepGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove);
 
 	AddConnectionGraphNode(AlwaysRelevantConnectionNode, ConnectionManager);
+
+	// Owner-only actors of this connection, filled by UGameplayReplicationGraph::UpdateOwnerOnlyActor
+	UGameRepGraphNode_OwnerOnly_ForConnection* OwnerOnlyConnectionNode = CreateNewNode<UGameRepGraphNode_OwnerOnly_ForConnection>();
+	AddConnectionGraphNode(OwnerOnlyConnectionNode, ConnectionManager);
+
+	// This node needs to be added last, it applies the per-class policies to everything the other nodes gathered
+	UGameRepGraphNode_ActorPolicy_ForConnection* ActorPolicyConnectionNode = CreateNewNode<UGameRepGraphNode_ActorPolicy_ForConnection>();
+	AddConnectionGraphNode(ActorPolicyConnectionNode, ConnectionManager);
 }
 
 void UGameplayReplicationGraph::RouteAddNetworkActorToNodes(
 	const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
 {
+	const FRepGraphClassPolicy* ClassPolicy = ClassPolicies.Get(ActorInfo.Class);
+	if (ClassPolicy && ClassPolicy->bAdaptiveFrequency && bAdaptiveFrequencies)
+	{
+		AdaptiveActors.Add(ActorInfo.Actor).ReplicationPeriodFrame = GlobalInfo.Settings.ReplicationPeriodFrame;
+	}
+
 	switch (GetMappingPolicy(ActorInfo.Class))
 	{
 	case EClassRepNodeMapping::NotRouted:
@@ -433,12 +732,61 @@ void UGameplayReplicationGraph::RouteAddNetworkActorToNodes(
 			}
 			else
 			{
-				FActorRepListRefView& RepList = AlwaysRelevantStreamingLevelActors.FindOrAdd(ActorInfo.StreamingLevelName);
-				RepList.ConditionalAdd(ActorInfo.Actor);
+				FActorRepListRefView* RepList = AlwaysRelevantStreamingLevelActors.Find(ActorInfo.StreamingLevelName);
+				if (RepList == nullptr)
+				{
+					// First actor of this level, reserve room for the whole level at once instead of growing per actor
+					RepList = &AlwaysRelevantStreamingLevelActors.Add(ActorInfo.StreamingLevelName);
+					RepList->Reserve(CountAlwaysRelevantActorsInLevel(ActorInfo.Actor->GetLevel()));
+
+					RemovedStreamingLevels.Remove(ActorInfo.StreamingLevelName);
+				}
+
+				RepList->ConditionalAdd(ActorInfo.Actor);
 			}
 			
 			break;
 		}
+
+	case EClassRepNodeMapping::RelevantOwnerOnly:
+		{
+			TWeakObjectPtr<UGameRepGraphNode_OwnerOnly_ForConnection>& OwnerNode = OwnerOnlyActors.Add(ActorInfo.GetActor());
+			UpdateOwnerOnlyActor(ActorInfo.GetActor(), OwnerNode);
+			break;
+		}
+
+	case EClassRepNodeMapping::DependentOnOwner:
+		{
+			TWeakObjectPtr<AActor>& DependentOwner = DependentActors.Add(ActorInfo.GetActor());
+			if (AActor* Owner = ActorInfo.GetActor()->GetOwner())
+			{
+				GlobalActorReplicationInfoMap.AddDependentActor(Owner, ActorInfo.GetActor());
+				DependentOwner = Owner;
+			}
+			else
+			{
+				// Nothing to depend on yet, it replicates on its own until it gets an owner
+				GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+			}
+
+			break;
+		}
+
+	case EClassRepNodeMapping::RelevantInterestGroup:
+		{
+			if (const FName* GroupName = ClassInterestGroups.Get(ActorInfo.Class))
+			{
+				InterestGroupNode->AddActorToGroup(ActorInfo, *GroupName);
+			}
+
+			break;
+		}
+
+	case EClassRepNodeMapping::ProjectileEvents:
+		{
+			ProjectileEventNode->NotifyAddNetworkActor(ActorInfo);
+			break;
+		}
 		
 	case EClassRepNodeMapping::Spatialize_Static:
 		{
@@ -462,6 +810,29 @@ void UGameplayReplicationGraph::RouteAddNetworkActorToNodes(
 
 void UGameplayReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
 {
+	// Any actor can be published to interest groups, no matter how it's routed
+	InterestGroupNode->NotifyRemoveNetworkActor(ActorInfo, false);
+
+	ActorDirtyFrames.Remove(ActorInfo.Actor);
+	AdaptiveActors.Remove(ActorInfo.Actor);
+	DeactivatedPooledActors.Remove(ActorInfo.Actor);
+
+	// Per-connection policy state only exists for classes with connection policies
+	const FRepGraphClassPolicy* ClassPolicy = ClassPolicies.Get(ActorInfo.Class);
+	if (ClassPolicy && ClassPolicy->HasConnectionPolicies())
+	{
+		for (UNetReplicationGraphConnection* ConnectionManager : Connections)
+		{
+			for (UReplicationGraphNode* ConnectionNode : ConnectionManager->GetConnectionGraphNodes())
+			{
+				if (UGameRepGraphNode_ActorPolicy_ForConnection* ActorPolicyNode = Cast<UGameRepGraphNode_ActorPolicy_ForConnection>(ConnectionNode))
+				{
+					ActorPolicyNode->NotifyRemoveNetworkActor(ActorInfo, false);
+				}
+			}
+		}
+	}
+
 	switch (GetMappingPolicy(ActorInfo.Class)) {
 	case EClassRepNodeMapping::NotRouted:
 		{
@@ -474,10 +845,23 @@ void UGameplayReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplica
 			{
 				AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
 			}
+			else if (int32* NumRemainingActors = RemovedStreamingLevels.Find(ActorInfo.StreamingLevelName))
+			{
+				// The whole list for this level was already dropped, forget the level once its last actor is gone
+				if (--(*NumRemainingActors) <= 0)
+				{
+					RemovedStreamingLevels.Remove(ActorInfo.StreamingLevelName);
+				}
+			}
+			else if (ActorInfo.Actor->GetLevel() && ActorInfo.Actor->GetLevel()->bIsBeingRemoved)
+			{
+				// The level is unloading, drop its whole list at once instead of searching it for every actor
+				RemoveStreamingLevelActors(ActorInfo.StreamingLevelName);
+			}
 			else
 			{
-				FActorRepListRefView& RepList = AlwaysRelevantStreamingLevelActors.FindChecked(ActorInfo.StreamingLevelName);
-				if (RepList.RemoveFast(ActorInfo.Actor) == false)
+				FActorRepListRefView* RepList = AlwaysRelevantStreamingLevelActors.Find(ActorInfo.StreamingLevelName);
+				if (RepList == nullptr || RepList->RemoveFast(ActorInfo.Actor) == false)
 				{
 					UE_LOG(LogGameRepGraph, Warning, TEXT("Actor %s was not found in AlwaysRelevantStreamingLevelActors list. LevelName: %s"), *GetActorRepListTypeDebugString(ActorInfo.Actor), *ActorInfo.StreamingLevelName.ToString());
 				}					
@@ -487,479 +871,2518 @@ void UGameplayReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplica
 			
 			break;
 		}
+
+	case EClassRepNodeMapping::RelevantOwnerOnly:
+		{
+			TWeakObjectPtr<UGameRepGraphNode_OwnerOnly_ForConnection> OwnerNode;
+			if (OwnerOnlyActors.RemoveAndCopyValue(ActorInfo.GetActor(), OwnerNode) && OwnerNode.IsValid())
+			{
+				OwnerNode->NotifyRemoveNetworkActor(ActorInfo);
+			}
+
+			break;
+		}
+
+	case EClassRepNodeMapping::DependentOnOwner:
+		{
+			TWeakObjectPtr<AActor> DependentOwner;
+			if (DependentActors.RemoveAndCopyValue(ActorInfo.GetActor(), DependentOwner))
+			{
+				if (DependentOwner.IsExplicitlyNull())
+				{
+					GridNode->RemoveActor_Dynamic(ActorInfo);
+					GridNode->NotifyActorRemoved(ActorInfo.Actor);
+				}
+				else if (DependentOwner.IsValid())
+				{
+					GlobalActorReplicationInfoMap.RemoveDependentActor(DependentOwner.Get(), ActorInfo.GetActor());
+				}
+			}
+
+			break;
+		}
+
+	case EClassRepNodeMapping::RelevantInterestGroup:
+		{
+			// Already removed from all of its interest groups above
+			break;
+		}
+
+	case EClassRepNodeMapping::ProjectileEvents:
+		{
+			ProjectileEventNode->NotifyRemoveNetworkActor(ActorInfo);
+			break;
+		}
+
 	case EClassRepNodeMapping::Spatialize_Static:
 		{
 			GridNode->RemoveActor_Static(ActorInfo);
+			GridNode->NotifyActorRemoved(ActorInfo.Actor);
 			break;
 		}
 		
 	case EClassRepNodeMapping::Spatialize_Dynamic:
 		{
 			GridNode->RemoveActor_Dynamic(ActorInfo);
+			GridNode->NotifyActorRemoved(ActorInfo.Actor);
 			break;
 		}
 		
 	case EClassRepNodeMapping::Spatialize_Dormancy:
 		{
 			GridNode->RemoveActor_Dormancy(ActorInfo);
+			GridNode->NotifyActorRemoved(ActorInfo.Actor);
 			break;
 		}
 	}
 }
 
-
-void UGameplayReplicationGraph::AddClassRepInfo(UClass* Class, EClassRepNodeMapping Mapping)
+void UGameplayReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection)
 {
-	if (IsSpatialized(Mapping))
+	auto RemoveConnectionState = [this, NetConnection](const TArray<TObjectPtr<UNetReplicationGraphConnection>>& ConnectionList)
 	{
-		if (Class->GetDefaultObject<AActor>()->bAlwaysRelevant)
+		for (UNetReplicationGraphConnection* ConnectionManager : ConnectionList)
 		{
-			UE_LOG(LogGameRepGraph, Warning, TEXT("Replicated Class %s is AlwaysRelevant but is initialized into a spatialized node (%s)"),
-				*Class->GetName(), *StaticEnum<EClassRepNodeMapping>()->GetNameStringByValue((int64)Mapping));
+			if (ConnectionManager && ConnectionManager->NetConnection == NetConnection)
+			{
+				InterestGroupNode->RemoveConnection(ConnectionManager);
+				GridNode->RemoveConnection(ConnectionManager);
+			}
 		}
-	}
+	};
 
-	ClassRepNodePolicies.Set(Class, Mapping);
-}
+	RemoveConnectionState(Connections);
+	RemoveConnectionState(PendingConnections);
 
-void UGameplayReplicationGraph::RegisterClassRepNodeMapping(UClass* Class)
-{
-	const EClassRepNodeMapping Mapping = GetClassNodeMapping(Class);
-	ClassRepNodePolicies.Set(Class, Mapping);
+	Super::RemoveClientConnection(NetConnection);
 }
 
-EClassRepNodeMapping UGameplayReplicationGraph::GetClassNodeMapping(UClass* Class) const
+void UGameplayReplicationGraph::RemoveStreamingLevelActors(FName StreamingLevelName)
 {
-	if (!Class)
+	if (StreamingLevelName == NAME_None)
 	{
-		return EClassRepNodeMapping::NotRouted;
+		return;
 	}
-	
-	if (const EClassRepNodeMapping* Ptr = ClassRepNodePolicies.FindWithoutClassRecursion(Class))
+
+	const FActorRepListRefView* RepList = AlwaysRelevantStreamingLevelActors.Find(StreamingLevelName);
+	if (RepList == nullptr)
 	{
-		return *Ptr;
+		return;
 	}
-	
-	AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
-	if (!ActorCDO || !ActorCDO->GetIsReplicated())
+
+	// The actor being routed out right now is one of them
+	const int32 NumRemainingActors = RepList->Num() - 1;
+	AlwaysRelevantStreamingLevelActors.Remove(StreamingLevelName);
+	if (NumRemainingActors > 0)
 	{
-		return EClassRepNodeMapping::NotRouted;
+		RemovedStreamingLevels.Add(StreamingLevelName, NumRemainingActors);
 	}
-		
-	auto ShouldSpatialize = [](const AActor* CDO)
+
+	UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING Dropped AlwaysRelevantStreamingLevelActors list for %s in bulk"), *StreamingLevelName.ToString());
+}
+
+void UGameplayReplicationGraph::UpdateDependentActor(AActor* Actor, TWeakObjectPtr<AActor>& InOutOwner)
+{
+	// Explicitly null while the actor has no owner and is spatialized on its own, a destroyed owner only leaves a stale pointer
+	const bool bWasSpatialized = InOutOwner.IsExplicitlyNull();
+	AActor* OldOwner = InOutOwner.Get();
+	AActor* NewOwner = Actor->GetOwner();
+	if (OldOwner == NewOwner && (NewOwner != nullptr || bWasSpatialized))
 	{
-		return CDO->GetIsReplicated() && (!(CDO->bAlwaysRelevant || CDO->bOnlyRelevantToOwner || CDO->bNetUseOwnerRelevancy));
-	};
+		return;
+	}
 
-	auto GetLegacyDebugStr = [](const AActor* CDO)
+	if (OldOwner)
 	{
-		return FString::Printf(TEXT("%s [%d/%d/%d]"), *CDO->GetClass()->GetName(), CDO->bAlwaysRelevant, CDO->bOnlyRelevantToOwner, CDO->bNetUseOwnerRelevancy);
-	};
+		GlobalActorReplicationInfoMap.RemoveDependentActor(OldOwner, Actor);
+	}
 
-	// Only handle this class if it differs from its Super. There is no need to put every child class explicitly in the graph class mapping
-	UClass* SuperClass = Class->GetSuperClass();
-	if (AActor* SuperCDO = Cast<AActor>(SuperClass->GetDefaultObject()))
+	const FNewReplicatedActorInfo ActorInfo(Actor);
+	if (NewOwner)
 	{
-		if (SuperCDO->GetIsReplicated() == ActorCDO->GetIsReplicated()
-			&& SuperCDO->bAlwaysRelevant == ActorCDO->bAlwaysRelevant
-			&& SuperCDO->bOnlyRelevantToOwner == ActorCDO->bOnlyRelevantToOwner
-			&& SuperCDO->bNetUseOwnerRelevancy == ActorCDO->bNetUseOwnerRelevancy
-			)
+		if (bWasSpatialized)
 		{
-			return GetClassNodeMapping(SuperClass);
+			GridNode->RemoveActor_Dynamic(ActorInfo);
+			GridNode->NotifyActorRemoved(Actor);
+		}
+
+		// Inherits relevancy, priority and channel lifetime from the owner
+		GlobalActorReplicationInfoMap.AddDependentActor(NewOwner, Actor);
+		InOutOwner = NewOwner;
+	}
+	else
+	{
+		if (!bWasSpatialized)
+		{
+			GridNode->AddActor_Dynamic(ActorInfo, GlobalActorReplicationInfoMap.Get(Actor));
 		}
+
+		InOutOwner.Reset();
 	}
+}
 
-	if (ShouldSpatialize(ActorCDO))
+void UGameplayReplicationGraph::AddActorToInterestGroup(AActor* Actor, FName GroupName)
+{
+	if (Actor == nullptr || GroupName.IsNone())
 	{
-		return EClassRepNodeMapping::Spatialize_Dynamic;
+		return;
 	}
-	else if (ActorCDO->bAlwaysRelevant && !ActorCDO->bOnlyRelevantToOwner)
+
+	// Only actors known to the graph get removed from their groups again
+	if (GlobalActorReplicationInfoMap.Find(Actor) == nullptr)
 	{
-		return EClassRepNodeMapping::RelevantAllConnections;
+		UE_LOG(LogGameRepGraph, Warning, TEXT("AddActorToInterestGroup: %s is not a replicated actor known to the replication graph. Group: %s"), *GetNameSafe(Actor), *GroupName.ToString());
+		return;
 	}
 
-	return EClassRepNodeMapping::NotRouted;
+	InterestGroupNode->AddActorToGroup(FNewReplicatedActorInfo(Actor), GroupName);
 }
 
-void UGameplayReplicationGraph::RegisterClassReplicationInfo(UClass* Class)
+void UGameplayReplicationGraph::RemoveActorFromInterestGroup(AActor* Actor, FName GroupName)
 {
-	FClassReplicationInfo ClassInfo;
-	if (ConditionalInitClassReplicationInfo(Class, ClassInfo))
+	if (Actor)
 	{
-		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
-		UE_LOG(LogGameRepGraph, Log, TEXT("Class %s registered with replication info."), *Class->GetName());
-		UE_LOG(LogGameRepGraph, Log, TEXT("Setting %s - %.2f"), *GetNameSafe(Class), ClassInfo.GetCullDistance());
+		InterestGroupNode->RemoveActorFromGroup(FNewReplicatedActorInfo(Actor), GroupName);
 	}
 }
 
-bool UGameplayReplicationGraph::ConditionalInitClassReplicationInfo(UClass* Class, FClassReplicationInfo& ClassInfo)
+void UGameplayReplicationGraph::SubscribeToInterestGroup(APlayerController* PC, FName GroupName)
 {
-	if (ExplicitlySetClasses.FindByPredicate([&](const UClass* SetClass)->bool
-	{
-		return Class->IsChildOf(SetClass);
-	}) != nullptr)
+	if (UNetReplicationGraphConnection* ConnectionManager = FindConnectionManagerForActor(PC))
 	{
-		return false;
+		InterestGroupNode->SubscribeConnection(ConnectionManager, GroupName);
 	}
-
-	const bool bClassIsSpatialized = IsSpatialized(ClassRepNodePolicies.GetChecked(Class));
-	InitClassReplicationInfo(ClassInfo, Class, bClassIsSpatialized);
-	return true;
 }
 
-void UGameplayReplicationGraph::InitClassReplicationInfo(
-	FClassReplicationInfo& Info, UClass* Class, bool Spatialize) const
+void UGameplayReplicationGraph::UnsubscribeFromInterestGroup(APlayerController* PC, FName GroupName)
 {
-	const AActor* CDO = Class->GetDefaultObject<AActor>();
-	if (Spatialize)
+	if (UNetReplicationGraphConnection* ConnectionManager = FindConnectionManagerForActor(PC))
 	{
-		Info.SetCullDistanceSquared(CDO->GetNetCullDistanceSquared());
-		UE_LOG(LogGameRepGraph, Log, TEXT("Setting cull distance for %s to %f (%f)"),
-			*Class->GetName(), Info.GetCullDistanceSquared(), Info.GetCullDistance());
+		InterestGroupNode->UnsubscribeConnection(ConnectionManager, GroupName);
 	}
+}
 
-	Info.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(CDO->GetNetUpdateFrequency());
-
-	UClass* NativeClass = Class;
-	while (!NativeClass->IsNative() && NativeClass->GetSuperClass() && NativeClass->GetSuperClass() != AActor::StaticClass())
+UNetReplicationGraphConnection* UGameplayReplicationGraph::FindConnectionManagerForActor(const AActor* Actor)
+{
+	if (Actor)
 	{
-		NativeClass = NativeClass->GetSuperClass();
-	}
+		if (UNetConnection* NetConnection = Actor->GetNetConnection())
+		{
+			// Child connections (splitscreen) are viewers of their parent connection
+			if (UChildConnection* ChildConnection = NetConnection->GetUChildConnection())
+			{
+				NetConnection = ChildConnection->Parent;
+			}
 
-	UE_LOG(LogGameRepGraph, Log, TEXT("Setting replication period for %s (%s) to %d frames (%.2f)"),
-		*Class->GetName(), *NativeClass->GetName(), Info.ReplicationPeriodFrame, CDO->GetNetUpdateFrequency());
-}
+			if (NetConnection && NetConnection->GetDriver() == NetDriver)
+			{
+				return FindOrAddConnectionManager(NetConnection);
+			}
+		}
+	}
 
-EClassRepNodeMapping UGameplayReplicationGraph::GetMappingPolicy(UClass* Class)
-{
-	const EClassRepNodeMapping* PolicyPtr = ClassRepNodePolicies.Get(Class);
-	const EClassRepNodeMapping Policy = PolicyPtr ? *PolicyPtr : EClassRepNodeMapping::NotRouted;
-	return Policy;
+	return nullptr;
 }
 
-// Since we listen to global (static) events, we need to watch out for cross-world broadcasts (PIE)
-#if WITH_EDITOR
-#define CHECK_WORLDS(X) if(X->GetWorld() != GetWorld()) return;
-#else
-#define CHECK_WORLDS(X)
-#endif
-
-#if WITH_GAMEPLAY_DEBUGGER
-void UGameplayReplicationGraph::OnGameplayDebuggerOwnerChange(
-	AGameplayDebuggerCategoryReplicator* Debugger, APlayerController* OldOwner)
+template<typename NodeType>
+NodeType* UGameplayReplicationGraph::FindConnectionNodeForActor(const AActor* Actor)
 {
-	CHECK_WORLDS(Debugger);
-
-	auto GetAlwaysRelevantForConnectionNode = [this](APlayerController* Controller) -> UGameRepGraphNode_AlwaysRelevant_ForConnection*
+	if (UNetReplicationGraphConnection* GraphConnection = FindConnectionManagerForActor(Actor))
 	{
-		if (Controller)
+		for (UReplicationGraphNode* ConnectionNode : GraphConnection->GetConnectionGraphNodes())
 		{
-			if (UNetConnection* NetConnection = Controller->GetNetConnection())
+			if (NodeType* TypedNode = Cast<NodeType>(ConnectionNode))
 			{
-				if (NetConnection->GetDriver() == NetDriver)
-				{
-					if (UNetReplicationGraphConnection* GraphConnection = FindOrAddConnectionManager(NetConnection))
-					{
-						for (UReplicationGraphNode* ConnectionNode : GraphConnection->GetConnectionGraphNodes())
-						{
-							if (UGameRepGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = Cast<UGameRepGraphNode_AlwaysRelevant_ForConnection>(ConnectionNode))
-							{
-								return AlwaysRelevantConnectionNode;
-							}
-						}
-					}
-				}
+				return TypedNode;
 			}
 		}
+	}
 
-		return nullptr;
-	};
+	return nullptr;
+}
 
-	if (UGameRepGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = GetAlwaysRelevantForConnectionNode(OldOwner))
+void UGameplayReplicationGraph::SetConnectionCullDistanceScale(APlayerController* PC, float CullDistanceScale)
+{
+	if (UGameRepGraphNode_ActorPolicy_ForConnection* ActorPolicyNode = FindConnectionNodeForActor<UGameRepGraphNode_ActorPolicy_ForConnection>(PC))
 	{
-		AlwaysRelevantConnectionNode->GameplayDebugger = nullptr;
+		ActorPolicyNode->SetCullDistanceScale(CullDistanceScale);
 	}
+}
 
-	if (UGameRepGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = GetAlwaysRelevantForConnectionNode(Debugger->GetReplicationOwner()))
+void UGameplayReplicationGraph::MarkActorDirty(AActor* Actor)
+{
+	const UNetDriver* NetDriver = Actor ? Actor->GetNetDriver() : nullptr;
+	if (UGameplayReplicationGraph* GameGraph = NetDriver ? Cast<UGameplayReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr)
 	{
-		AlwaysRelevantConnectionNode->GameplayDebugger = Debugger;
+		GameGraph->NotifyActorDirty(Actor);
 	}
 }
-#endif
-#undef CHECK_WORLDS
 
-
-void UGameplayReplicationGraph::PrintRepNodePolicies()
+void UGameplayReplicationGraph::NotifyActorDirty(AActor* Actor)
 {
-	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
-	if (!Enum)
+	// Actors the graph doesn't know yet have no channel to skip
+	if (GlobalActorReplicationInfoMap.Find(Actor))
 	{
-		return;
+		ActorDirtyFrames.Add(Actor, GetReplicationGraphFrame());
 	}
+}
 
-	GLog->Logf(TEXT("===================================="));
-	GLog->Logf(TEXT("Game Replication Routing Policies"));
-	GLog->Logf(TEXT("===================================="));
-
-	for (auto It = ClassRepNodePolicies.CreateIterator(); It; ++It)
+void UGameplayReplicationGraph::ReportProjectileImpact(AActor* Projectile, const FHitResult& Hit)
+{
+	const UNetDriver* NetDriver = Projectile ? Projectile->GetNetDriver() : nullptr;
+	if (UGameplayReplicationGraph* GameGraph = NetDriver ? Cast<UGameplayReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr)
 	{
-		FObjectKey ObjKey = It.Key();
-		
-		EClassRepNodeMapping Mapping = It.Value();
+		GameGraph->NotifyProjectileImpact(Projectile, Hit);
+	}
+}
 
-		GLog->Logf(TEXT("%-40s --> %s"), *GetNameSafe(ObjKey.ResolveObjectPtr()), *Enum->GetNameStringByValue(static_cast<uint32>(Mapping)));
+void UGameplayReplicationGraph::NotifyProjectileImpact(AActor* Projectile, const FHitResult& Hit)
+{
+	if (GetMappingPolicy(Projectile->GetClass()) == EClassRepNodeMapping::ProjectileEvents)
+	{
+		ProjectileEventNode->AddImpact(Projectile, Hit);
 	}
 }
 
-// --------------------------------------------------------------------------------------------------------------------
-// Console Commands
-// --------------------------------------------------------------------------------------------------------------------
+void UGameplayReplicationGraph::DeactivatePooledActor(AActor* Actor)
+{
+	if (Actor == nullptr || !Actor->HasAuthority())
+	{
+		return;
+	}
 
-FAutoConsoleCommandWithWorldAndArgs PrintRepNodePolicyCmd(TEXT("GameRepGraph.PrintRouting"),TEXT("Prints how actor classes are routed to RepGraph nodes"),
-	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+
+	// The channels only turn dormant once the hidden state has been sent and acked
+	Actor->SetNetDormancy(DORM_DormantAll);
+
+	const UNetDriver* NetDriver = Actor->GetNetDriver();
+	if (UGameplayReplicationGraph* GameGraph = NetDriver ? Cast<UGameplayReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr)
 	{
-		for (TObjectIterator<UGameplayReplicationGraph> It; It; ++It)
-		{
-			It->PrintRepNodePolicies();
-		}
-	})
-);
+		GameGraph->NotifyPooledActorActive(Actor, false);
+	}
+}
 
-FAutoConsoleCommandWithWorldAndArgs ChangeFrequencyBucketsCmd(TEXT("GameRepGraph.FrequencyBuckets"), TEXT("Resets frequency bucket count."),
-	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray< FString >& Args, UWorld* World) 
+void UGameplayReplicationGraph::ActivatePooledActor(AActor* Actor, const FTransform& Transform)
 {
-	int32 Buckets = 1;
-	if (Args.Num() > 0)
+	if (Actor == nullptr || !Actor->HasAuthority())
 	{
-		LexTryParseString<int32>(Buckets, *Args[0]);
+		return;
 	}
 
-	UE_LOG(LogGameRepGraph, Display, TEXT("Setting Frequency Buckets to %d"), Buckets);
-	for (TObjectIterator<UReplicationGraphNode_ActorListFrequencyBuckets> It; It; ++It)
+	const UNetDriver* NetDriver = Actor->GetNetDriver();
+	if (UGameplayReplicationGraph* GameGraph = NetDriver ? Cast<UGameplayReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr)
 	{
-		UReplicationGraphNode_ActorListFrequencyBuckets* Node = *It;
-		Node->SetNonStreamingCollectionSize(Buckets);
+		GameGraph->NotifyPooledActorActive(Actor, true);
 	}
-}));
 
+	// Move while still dormant, the grid takes the actor out of its old static cells and tracks it as dynamic once it wakes up
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Actor->SetActorHiddenInGame(false);
+	Actor->SetActorEnableCollision(true);
+	Actor->SetActorTickEnabled(true);
 
-// --------------------------------------------------------------------------------------------------------------------
-// UGameRepGraphNode_AlwaysRelevant_ForConnection
-// --------------------------------------------------------------------------------------------------------------------
+	Actor->SetNetDormancy(DORM_Awake);
+	Actor->ForceNetUpdate();
+}
 
-void UGameRepGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(
-	const FConnectionGatherActorListParameters& Params)
+void UGameplayReplicationGraph::NotifyPooledActorActive(AActor* Actor, bool bActive)
 {
-	UGameplayReplicationGraph* GameGraph = CastChecked<UGameplayReplicationGraph>(GetOuter());
+	if (bActive)
+	{
+		DeactivatedPooledActors.Remove(Actor);
+	}
+	else if (GlobalActorReplicationInfoMap.Find(Actor))
+	{
+		DeactivatedPooledActors.Add(Actor);
+	}
+}
 
-	ReplicationActorList.Reset();
+void UGameplayReplicationGraph::ForceNetUpdate(AActor* Actor)
+{
+	NotifyActorDirty(Actor);
+	Super::ForceNetUpdate(Actor);
+}
 
-	for (const FNetViewer& CurViewer : Params.Viewers)
-	{
-		ReplicationActorList.ConditionalAdd(CurViewer.InViewer);
-		ReplicationActorList.ConditionalAdd(CurViewer.ViewTarget);
+void UGameplayReplicationGraph::FlushNetDormancy(AActor* Actor, bool WasDormInitial)
+{
+	NotifyActorDirty(Actor);
+	Super::FlushNetDormancy(Actor, WasDormInitial);
+}
 
-		if (APlayerController* PC = Cast<APlayerController>(CurViewer.InViewer))
-		{
-			// 50% throttling of PlayerStates.
-			const bool bReplicatePS = (Params.ConnectionManager.ConnectionOrderNum % 2) == (Params.ReplicationFrameNum % 2);
-			if (bReplicatePS)
-			{
-				// Always return the player state to the owning player. Simulated proxy player states are handled by UGameRepGraphNode_PlayerStateFrequenceLimiter.
-				if (APlayerState* PS = PC->PlayerState)
-				{
-					if (!bInitializedPlayerState)
-					{
-						bInitializedPlayerState = true;
-						FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(PS);
-						ConnectionActorInfo.ReplicationPeriodFrame = 1;
-					}
+void UGameplayReplicationGraph::TearDown()
+{
+	if (AdaptiveClassStats.Num() > 0)
+	{
+		PrintAdaptiveFrequencies(true);
+	}
 
-					ReplicationActorList.ConditionalAdd(PS);
-				}
-			}
+	Super::TearDown();
+}
 
-			FCachedAlwaysRelevantActorInfo& LastData = PastRelevantActorMap.FindOrAdd(CurViewer.Connection);
+int32 UGameplayReplicationGraph::GetConnectionActorLODTier(APlayerController* PC, AActor* Actor)
+{
+	const UGameRepGraphNode_ActorPolicy_ForConnection* ActorPolicyNode = FindConnectionNodeForActor<UGameRepGraphNode_ActorPolicy_ForConnection>(PC);
+	return ActorPolicyNode ? ActorPolicyNode->GetActorLODTier(Actor) : 0;
+}
 
-			if (ACharacter* Pawn = Cast<ACharacter>(PC->GetPawn()))
-			{
-				UpdateCachedRelevantActor(Params, Pawn, LastData.LastViewer);
+int32 UGameplayReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	JoinChannelOpenBudget = GameplayRepGraph::JoinMaxChannelOpensPerFrame > 0 ? GameplayRepGraph::JoinMaxChannelOpensPerFrame : MAX_int32;
 
-				if (Pawn != CurViewer.ViewTarget)
-				{
-					ReplicationActorList.ConditionalAdd(Pawn);
-				}
-			}
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumReplicated = Super::ServerReplicateActors(DeltaSeconds);
 
-			if (ACharacter* ViewTargetPawn = Cast<ACharacter>(CurViewer.ViewTarget))
-			{
-				UpdateCachedRelevantActor(Params, ViewTargetPawn, LastData.LastViewTarget);
-			}
-		}
+	// Gathering has no side effects, the projectile events go out once every connection got its actors
+	if (ProjectileEventNode)
+	{
+		ProjectileEventNode->FlushEvents();
 	}
 
-	CleanupCachedRelevantActors(PastRelevantActorMap);
+	UpdateGovernor((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	UpdateAdaptiveFrequencies();
+	return NumReplicated;
+}
 
-	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+void UGameplayReplicationGraph::UpdateAdaptiveFrequencies()
+{
+	const uint32 FrameNum = GetReplicationGraphFrame();
+	const uint32 IntervalFrames = (uint32)FMath::Max(GameplayRepGraph::AdaptiveIntervalFrames, 1);
+	if (GameplayRepGraph::EnableAdaptiveFrequency == 0 || AdaptiveActors.Num() == 0 || FrameNum - LastAdaptiveUpdateFrame < IntervalFrames)
+	{
+		return;
+	}
 
-	// Always relevant streaming level actors.
-	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
-	
-	TMap<FName, FActorRepListRefView>& AlwaysRelevantStreamingLevelActors = GameGraph->AlwaysRelevantStreamingLevelActors;
+	const uint32 IntervalStartFrame = LastAdaptiveUpdateFrame;
+	LastAdaptiveUpdateFrame = FrameNum;
 
-	for (int32 Idx=AlwaysRelevantStreamingLevelsNeedingReplication.Num()-1; Idx >= 0; --Idx)
+	for (auto& ActorIt : AdaptiveActors)
 	{
-		const FName& StreamingLevel = AlwaysRelevantStreamingLevelsNeedingReplication[Idx];
+		AActor* Actor = ActorIt.Key;
+		FAdaptiveActorState& State = ActorIt.Value;
 
-		FActorRepListRefView* Ptr = AlwaysRelevantStreamingLevelActors.Find(StreamingLevel);
-		if (Ptr == nullptr)
+		// Actors that weren't replicated to anyone during the interval tell us nothing
+		FGlobalActorReplicationInfo* GlobalInfo = GlobalActorReplicationInfoMap.Find(Actor);
+		if (GlobalInfo == nullptr || GlobalInfo->LastPreReplicationFrame <= IntervalStartFrame)
 		{
-			// No always relevant lists for that level
-			UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING Removing %s from AlwaysRelevantStreamingLevelActors because FActorRepListRefView is null. %s "), *StreamingLevel.ToString(),  *Params.ConnectionManager.GetName());
-			AlwaysRelevantStreamingLevelsNeedingReplication.RemoveAtSwap(Idx, 1, EAllowShrinking::No);
 			continue;
 		}
 
-		FActorRepListRefView& RepList = *Ptr;
+		// GetReplicationChangeListMgr would create one, actors that never replicated don't have one yet
+		const FReplicationChangelistMgrWrapper* ChangelistMgrWrapper = NetDriver->ReplicationChangeListMap.Find(Actor);
+		const TSharedPtr<FReplicationChangelistMgr> ChangelistMgr = ChangelistMgrWrapper ? ChangelistMgrWrapper->ReplicationChangelistMgr : nullptr;
+		const FRepChangelistState* ChangelistState = ChangelistMgr.IsValid() ? ChangelistMgr->GetRepChangelistState() : nullptr;
+		if (ChangelistState == nullptr)
+		{
+			continue;
+		}
 
-		if (RepList.Num() > 0)
+		// Every compare that found changed properties adds a changelist to the history
+		const int32 NumChanges = ChangelistState->HistoryEnd - State.LastHistoryEnd;
+		const int32 NumCompares = ChangelistState->CompareIndex - State.LastCompareIndex;
+		const bool bHasBaseline = State.LastHistoryEnd != INDEX_NONE;
+		State.LastHistoryEnd = ChangelistState->HistoryEnd;
+		State.LastCompareIndex = ChangelistState->CompareIndex;
+
+		if (!bHasBaseline || NumCompares <= 0)
 		{
-			bool bAllDormant = true;
-			for (FActorRepListType Actor : RepList)
+			continue;
+		}
+
+		// How many of the actual replications during the interval carried changed data. The properties are compared once per frame
+		// the actor replicates to anyone, so this follows the periods the policy nodes set per connection, not just the class' period.
+		const float ChangePct = (float)NumChanges / NumCompares;
+
+		const FRepGraphClassPolicy* ClassPolicy = ClassPolicies.Get(Actor->GetClass());
+		uint32 ReplicationPeriodFrame = State.ReplicationPeriodFrame;
+		if (ChangePct <= GameplayRepGraph::AdaptiveLowChangePct)
+		{
+			ReplicationPeriodFrame *= 2;
+		}
+		else if (ChangePct >= GameplayRepGraph::AdaptiveHighChangePct)
+		{
+			ReplicationPeriodFrame /= 2;
+		}
+
+		ReplicationPeriodFrame = FMath::Clamp(ReplicationPeriodFrame, ClassPolicy->AdaptiveMinReplicationPeriodFrame, ClassPolicy->AdaptiveMaxReplicationPeriodFrame);
+		if (ReplicationPeriodFrame != State.ReplicationPeriodFrame)
+		{
+			State.ReplicationPeriodFrame = ReplicationPeriodFrame;
+			GlobalInfo->Settings.ReplicationPeriodFrame = ReplicationPeriodFrame;
+
+			// Policy nodes pick the new period up on their own, everyone else needs it set on their actor info
+			for (UNetReplicationGraphConnection* ConnectionManager : Connections)
 			{
-				FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
-				if (ConnectionActorInfo.bDormantOnConnection == false)
+				if (FConnectionReplicationActorInfo* ConnectionInfo = ConnectionManager->ActorInfoMap.Find(Actor))
 				{
-					bAllDormant = false;
-					break;
+					ConnectionInfo->NextReplicationFrameNum = FMath::Min<uint32>(ConnectionInfo->NextReplicationFrameNum, ConnectionInfo->LastRepFrameNum + ReplicationPeriodFrame);
+					ConnectionInfo->ReplicationPeriodFrame = ReplicationPeriodFrame;
 				}
 			}
-
-			if (bAllDormant)
-			{
-				UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING All AlwaysRelevant Actors Dormant on StreamingLevel %s for %s. Removing list."), *StreamingLevel.ToString(), *Params.ConnectionManager.GetName());
-				AlwaysRelevantStreamingLevelsNeedingReplication.RemoveAtSwap(Idx, 1, EAllowShrinking::No);
-			}
-			else
-			{
-				UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING Adding always Actors on StreamingLevel %s for %s because it has at least one non dormant actor"), *StreamingLevel.ToString(), *Params.ConnectionManager.GetName());
-				Params.OutGatheredReplicationLists.AddReplicationActorList(RepList);
-			}
 		}
-		else
+
+		FAdaptiveClassStats& ClassStats = AdaptiveClassStats.FindOrAdd(Actor->GetClass());
+		ClassStats.ReplicationPeriodSum += ReplicationPeriodFrame;
+		ClassStats.NumSamples++;
+	}
+}
+
+void UGameplayReplicationGraph::UpdateGovernor(double FrameTimeMs)
+{
+	if (GameplayRepGraph::EnableGovernor == 0)
+	{
+		if (GovernorLevel != 0)
 		{
-			UE_LOG(LogGameRepGraph, Warning, TEXT("UGameRepGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection - empty RepList %s"), *Params.ConnectionManager.GetName());
+			UE_LOG(LogGameRepGraph, Log, TEXT("Governor: disabled, resetting from level %d"), GovernorLevel);
+			ApplyGovernorLevel(0);
 		}
 
+		GovernorAccumulatedMs = 0.0;
+		GovernorNumFrames = 0;
+		return;
 	}
 
-#if WITH_GAMEPLAY_DEBUGGER
-	if (GameplayDebugger)
+	GovernorAccumulatedMs += FrameTimeMs;
+	if (++GovernorNumFrames < FMath::Max(GameplayRepGraph::GovernorAdjustIntervalFrames, 1))
 	{
-		ReplicationActorList.ConditionalAdd(GameplayDebugger);
+		return;
+	}
+
+	const double AverageMs = GovernorAccumulatedMs / GovernorNumFrames;
+	GovernorAccumulatedMs = 0.0;
+	GovernorNumFrames = 0;
+
+	int32 NewLevel = GovernorLevel;
+	if (AverageMs > GameplayRepGraph::GovernorTargetMs)
+	{
+		NewLevel = FMath::Min(GovernorLevel + 1, FMath::Max(GameplayRepGraph::GovernorMaxLevel, 0));
+	}
+	else if (AverageMs < GameplayRepGraph::GovernorTargetMs * GameplayRepGraph::GovernorRecoveryPct)
+	{
+		NewLevel = FMath::Max(GovernorLevel - 1, 0);
+	}
+
+	if (NewLevel != GovernorLevel)
+	{
+		UE_LOG(LogGameRepGraph, Log, TEXT("Governor: average %.2fms (target %.2fms), level %d -> %d"),
+			AverageMs, GameplayRepGraph::GovernorTargetMs, GovernorLevel, NewLevel);
+		ApplyGovernorLevel(NewLevel);
 	}
-#endif
 }
 
-void UGameRepGraphNode_AlwaysRelevant_ForConnection::LogNode(
-	FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+void UGameplayReplicationGraph::ApplyGovernorLevel(int32 NewLevel)
 {
-	DebugInfo.Log(NodeName);
-	DebugInfo.PushIndent();
-	LogActorRepList(DebugInfo, NodeName, ReplicationActorList);
+	GovernorLevel = NewLevel;
 
-	for (const FName& LevelName : AlwaysRelevantStreamingLevelsNeedingReplication)
+	// Every level moves the same share of the way from the configured values towards the governor's bounds
+	const float Alpha = GameplayRepGraph::GovernorMaxLevel > 0 ? FMath::Clamp((float)NewLevel / GameplayRepGraph::GovernorMaxLevel, 0.f, 1.f) : 0.f;
+
+	const int32 MaxBuckets = FMath::Max(GameplayRepGraph::GovernorMaxFrequencyBuckets, GameplayRepGraph::DynamicActorFrequencyBuckets);
+	const int32 NumBuckets = FMath::RoundToInt(FMath::Lerp((float)GameplayRepGraph::DynamicActorFrequencyBuckets, (float)MaxBuckets, Alpha));
+
+	GovernorPeriodScale = FMath::Lerp(1.f, FMath::Max(GameplayRepGraph::GovernorMaxPeriodScale, 1.f), Alpha);
+
+	const float FastSharedPct = FMath::Lerp(1.f, FMath::Clamp(GameplayRepGraph::GovernorMinFastSharedPct, 0.f, 1.f), Alpha);
+	FastSharedPathConstants.MaxBitsPerFrame = (int32)(BaseFastSharedMaxBitsPerFrame * FastSharedPct);
+
+	// New grid cells pick up our settings, existing ones need to be resized
+	if (DynamicBucketSettings.NumBuckets != NumBuckets)
 	{
-		UGameplayReplicationGraph* GameGraph = CastChecked<UGameplayReplicationGraph>(GetOuter());
-		if (FActorRepListRefView* RepList = GameGraph->AlwaysRelevantStreamingLevelActors.Find(LevelName))
+		DynamicBucketSettings.NumBuckets = NumBuckets;
+		for (UReplicationGraphNode_ActorListFrequencyBuckets* BucketNode : DynamicBucketNodes)
 		{
-			LogActorRepList(DebugInfo, FString::Printf(TEXT("AlwaysRelevant StreamingLevel List: %s"), *LevelName.ToString()), *RepList);
+			BucketNode->SetNonStreamingCollectionSize(NumBuckets);
 		}
 	}
 
-	DebugInfo.PopIndent();
+	UE_LOG(LogGameRepGraph, Log, TEXT("Governor: level %d applied. Frequency Buckets: %d, Distance Band Period Scale: %.2f, FastShared Bits Per Frame: %d"),
+		GovernorLevel, NumBuckets, GovernorPeriodScale, FastSharedPathConstants.MaxBitsPerFrame);
 }
 
-void UGameRepGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd(FName LevelName, UWorld* StreamingWorld)
+void UGameplayReplicationGraph::NotifyActorChannelOpened(const AActor* Actor)
 {
-	UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING Adding %s to AlwaysRelevantStreamingLevelActors for %s"), *LevelName.ToString(), *GetNameSafe(StreamingWorld));
-	AlwaysRelevantStreamingLevelsNeedingReplication.Add(LevelName);
+	if (Actor)
+	{
+		ClassChannelStats.FindOrAdd(Actor->GetClass()).NumOpened++;
+	}
 }
 
-void UGameRepGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove(FName LevelName)
+void UGameplayReplicationGraph::NotifyActorChannelClosed(const AActor* Actor)
 {
-	UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING Removing %s from AlwaysRelevantStreamingLevelActors for %s"), *LevelName.ToString(), *GetNameSafe(GetOuter()));
-	AlwaysRelevantStreamingLevelsNeedingReplication.Remove(LevelName);
+	if (Actor)
+	{
+		ClassChannelStats.FindOrAdd(Actor->GetClass()).NumClosed++;
+	}
 }
 
-void UGameRepGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState()
+void UGameplayReplicationGraph::NotifyActorOwnerChanged(AActor* Actor)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	// Dependent actors only ever follow their direct owner
+	if (TWeakObjectPtr<AActor>* DependentOwner = DependentActors.Find(Actor))
+	{
+		UpdateDependentActor(Actor, *DependentOwner);
+	}
+
+	if (OwnerOnlyActors.Num() == 0)
+	{
+		return;
+	}
+
+	// Owner-only actors can be owned through a chain (Weapon -> Pawn -> Controller), so everything owned by this actor may have moved
+	UpdateOwnedOwnerOnlyActors(Actor);
+}
+
+void UGameplayReplicationGraph::UpdateOwnedOwnerOnlyActors(AActor* Actor)
+{
+	if (TWeakObjectPtr<UGameRepGraphNode_OwnerOnly_ForConnection>* OwnerNode = OwnerOnlyActors.Find(Actor))
+	{
+		UpdateOwnerOnlyActor(Actor, *OwnerNode);
+	}
+
+	// The engine already indexes actors by owner, so we only walk this actor's subtree
+	for (AActor* Child : Actor->Children)
+	{
+		if (Child)
+		{
+			UpdateOwnedOwnerOnlyActors(Child);
+		}
+	}
+}
+
+void UGameplayReplicationGraph::SetActorOwner(AActor* Actor, AActor* NewOwner)
+{
+	if (Actor == nullptr || Actor->GetOwner() == NewOwner)
+	{
+		return;
+	}
+
+	Actor->SetOwner(NewOwner);
+
+	const UNetDriver* NetDriver = Actor->GetNetDriver();
+	if (UGameplayReplicationGraph* GameGraph = NetDriver ? Cast<UGameplayReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr)
+	{
+		GameGraph->NotifyActorOwnerChanged(Actor);
+	}
+}
+
+void UGameplayReplicationGraph::UpdateOwnerOnlyActor(AActor* Actor, TWeakObjectPtr<UGameRepGraphNode_OwnerOnly_ForConnection>& InOutOwnerNode)
+{
+	UGameRepGraphNode_OwnerOnly_ForConnection* OldNode = InOutOwnerNode.Get();
+	UGameRepGraphNode_OwnerOnly_ForConnection* NewNode = FindConnectionNodeForActor<UGameRepGraphNode_OwnerOnly_ForConnection>(Actor);
+	if (OldNode == NewNode)
+	{
+		return;
+	}
+
+	const FNewReplicatedActorInfo ActorInfo(Actor);
+	if (OldNode)
+	{
+		OldNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+
+	if (NewNode)
+	{
+		NewNode->NotifyAddNetworkActor(ActorInfo);
+	}
+
+	InOutOwnerNode = NewNode;
+}
+
+int32 UGameplayReplicationGraph::CountAlwaysRelevantActorsInLevel(const ULevel* Level)
+{
+	if (Level == nullptr)
+	{
+		return 0;
+	}
+
+	int32 NumActors = 0;
+	for (const AActor* Actor : Level->Actors)
+	{
+		if (Actor && Actor->GetIsReplicated() && GetMappingPolicy(Actor->GetClass()) == EClassRepNodeMapping::RelevantAllConnections)
+		{
+			++NumActors;
+		}
+	}
+
+	return NumActors;
+}
+
+void UGameplayReplicationGraph::AddClassRepInfo(UClass* Class, EClassRepNodeMapping Mapping)
+{
+	if (IsSpatialized(Mapping))
+	{
+		if (Class->GetDefaultObject<AActor>()->bAlwaysRelevant)
+		{
+			UE_LOG(LogGameRepGraph, Warning, TEXT("Replicated Class %s is AlwaysRelevant but is initialized into a spatialized node (%s)"),
+				*Class->GetName(), *StaticEnum<EClassRepNodeMapping>()->GetNameStringByValue((int64)Mapping));
+		}
+	}
+
+	ClassRepNodePolicies.Set(Class, Mapping);
+}
+
+void UGameplayReplicationGraph::RegisterClassRepNodeMapping(UClass* Class)
+{
+	const EClassRepNodeMapping Mapping = GetClassNodeMapping(Class);
+	ClassRepNodePolicies.Set(Class, Mapping);
+}
+
+EClassRepNodeMapping UGameplayReplicationGraph::GetClassNodeMapping(UClass* Class) const
+{
+	if (!Class)
+	{
+		return EClassRepNodeMapping::NotRouted;
+	}
+	
+	if (const EClassRepNodeMapping* Ptr = ClassRepNodePolicies.FindWithoutClassRecursion(Class))
+	{
+		return *Ptr;
+	}
+	
+	AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+	if (!ActorCDO || !ActorCDO->GetIsReplicated())
+	{
+		return EClassRepNodeMapping::NotRouted;
+	}
+
+	// Replicated as spawn and impact events by UGameRepGraphNode_ProjectileEvents
+	if (Class->ImplementsInterface(UEventReplicatedProjectile::StaticClass()))
+	{
+		return EClassRepNodeMapping::ProjectileEvents;
+	}
+		
+	auto ShouldSpatialize = [](const AActor* CDO)
+	{
+		return CDO->GetIsReplicated() && (!(CDO->bAlwaysRelevant || CDO->bOnlyRelevantToOwner || CDO->bNetUseOwnerRelevancy));
+	};
+
+	auto GetLegacyDebugStr = [](const AActor* CDO)
+	{
+		return FString::Printf(TEXT("%s [%d/%d/%d]"), *CDO->GetClass()->GetName(), CDO->bAlwaysRelevant, CDO->bOnlyRelevantToOwner, CDO->bNetUseOwnerRelevancy);
+	};
+
+	// Only handle this class if it differs from its Super. There is no need to put every child class explicitly in the graph class mapping
+	UClass* SuperClass = Class->GetSuperClass();
+	if (AActor* SuperCDO = Cast<AActor>(SuperClass->GetDefaultObject()))
+	{
+		if (SuperCDO->GetIsReplicated() == ActorCDO->GetIsReplicated()
+			&& SuperCDO->bAlwaysRelevant == ActorCDO->bAlwaysRelevant
+			&& SuperCDO->bOnlyRelevantToOwner == ActorCDO->bOnlyRelevantToOwner
+			&& SuperCDO->bNetUseOwnerRelevancy == ActorCDO->bNetUseOwnerRelevancy
+			)
+		{
+			return GetClassNodeMapping(SuperClass);
+		}
+	}
+
+	if (ShouldSpatialize(ActorCDO))
+	{
+		return EClassRepNodeMapping::Spatialize_Dynamic;
+	}
+	else if (ActorCDO->bAlwaysRelevant && !ActorCDO->bOnlyRelevantToOwner)
+	{
+		return EClassRepNodeMapping::RelevantAllConnections;
+	}
+	else if (ActorCDO->bOnlyRelevantToOwner && !Class->IsChildOf(AController::StaticClass()))
+	{
+		// Controllers are gathered as viewers by UGameRepGraphNode_AlwaysRelevant_ForConnection
+		return EClassRepNodeMapping::RelevantOwnerOnly;
+	}
+	else if (ActorCDO->bNetUseOwnerRelevancy)
+	{
+		return EClassRepNodeMapping::DependentOnOwner;
+	}
+
+	return EClassRepNodeMapping::NotRouted;
+}
+
+void UGameplayReplicationGraph::RegisterClassReplicationInfo(UClass* Class)
+{
+	FClassReplicationInfo ClassInfo;
+	if (ConditionalInitClassReplicationInfo(Class, ClassInfo))
+	{
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+		UE_LOG(LogGameRepGraph, Log, TEXT("Class %s registered with replication info."), *Class->GetName());
+		UE_LOG(LogGameRepGraph, Log, TEXT("Setting %s - %.2f"), *GetNameSafe(Class), ClassInfo.GetCullDistance());
+	}
+}
+
+bool UGameplayReplicationGraph::ConditionalInitClassReplicationInfo(UClass* Class, FClassReplicationInfo& ClassInfo)
+{
+	if (ExplicitlySetClasses.FindByPredicate([&](const UClass* SetClass)->bool
+	{
+		return Class->IsChildOf(SetClass);
+	}) != nullptr)
+	{
+		return false;
+	}
+
+	// Event replicated projectiles aren't spatialized, but their events are culled by the class' cull distance.
+	// Dependent actors are spatialized while they have no owner.
+	const EClassRepNodeMapping Mapping = ClassRepNodePolicies.GetChecked(Class);
+	const bool bClassIsSpatialized = IsSpatialized(Mapping) || Mapping == EClassRepNodeMapping::ProjectileEvents || Mapping == EClassRepNodeMapping::DependentOnOwner;
+	InitClassReplicationInfo(ClassInfo, Class, bClassIsSpatialized);
+	InflateClassCullDistance(Class, ClassInfo);
+	return true;
+}
+
+void UGameplayReplicationGraph::InflateClassCullDistance(UClass* Class, FClassReplicationInfo& Info)
+{
+	// Projectile events are culled with the class cull distance as is, no connection policy scales it back down
+	if (GetMappingPolicy(Class) == EClassRepNodeMapping::ProjectileEvents)
+	{
+		return;
+	}
+
+	const FRepGraphClassPolicy* ClassPolicy = ClassPolicies.Get(Class);
+	if (ClassPolicy && ClassPolicy->HasCullDistancePolicies() && Info.GetCullDistanceSquared() > 0.f)
+	{
+		Info.SetCullDistance(Info.GetCullDistance() * ClassPolicy->MaxCullDistanceScale + ClassPolicy->GetCullDistanceExtension());
+		UE_LOG(LogGameRepGraph, Log, TEXT("Extending cull distance for %s to %f (Scale: %.2f, Extension: %.2f)"),
+			*Class->GetName(), Info.GetCullDistance(), ClassPolicy->MaxCullDistanceScale, ClassPolicy->GetCullDistanceExtension());
+	}
+}
+
+void UGameplayReplicationGraph::InitClassReplicationInfo(
+	FClassReplicationInfo& Info, UClass* Class, bool Spatialize) const
+{
+	const AActor* CDO = Class->GetDefaultObject<AActor>();
+	if (Spatialize)
+	{
+		Info.SetCullDistanceSquared(CDO->GetNetCullDistanceSquared());
+		UE_LOG(LogGameRepGraph, Log, TEXT("Setting cull distance for %s to %f (%f)"),
+			*Class->GetName(), Info.GetCullDistanceSquared(), Info.GetCullDistance());
+	}
+
+	Info.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(CDO->GetNetUpdateFrequency());
+
+	UClass* NativeClass = Class;
+	while (!NativeClass->IsNative() && NativeClass->GetSuperClass() && NativeClass->GetSuperClass() != AActor::StaticClass())
+	{
+		NativeClass = NativeClass->GetSuperClass();
+	}
+
+	UE_LOG(LogGameRepGraph, Log, TEXT("Setting replication period for %s (%s) to %d frames (%.2f)"),
+		*Class->GetName(), *NativeClass->GetName(), Info.ReplicationPeriodFrame, CDO->GetNetUpdateFrequency());
+}
+
+EClassRepNodeMapping UGameplayReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	const EClassRepNodeMapping* PolicyPtr = ClassRepNodePolicies.Get(Class);
+	const EClassRepNodeMapping Policy = PolicyPtr ? *PolicyPtr : EClassRepNodeMapping::NotRouted;
+	return Policy;
+}
+
+// Since we listen to global (static) events, we need to watch out for cross-world broadcasts (PIE)
+#if WITH_EDITOR
+#define CHECK_WORLDS(X) if(X->GetWorld() != GetWorld()) return;
+#else
+#define CHECK_WORLDS(X)
+#endif
+
+#if WITH_GAMEPLAY_DEBUGGER
+void UGameplayReplicationGraph::OnGameplayDebuggerOwnerChange(
+	AGameplayDebuggerCategoryReplicator* Debugger, APlayerController* OldOwner)
+{
+	CHECK_WORLDS(Debugger);
+
+	if (UGameRepGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = FindConnectionNodeForActor<UGameRepGraphNode_AlwaysRelevant_ForConnection>(OldOwner))
+	{
+		AlwaysRelevantConnectionNode->GameplayDebugger = nullptr;
+	}
+
+	if (UGameRepGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = FindConnectionNodeForActor<UGameRepGraphNode_AlwaysRelevant_ForConnection>(Debugger->GetReplicationOwner()))
+	{
+		AlwaysRelevantConnectionNode->GameplayDebugger = Debugger;
+	}
+}
+#endif
+#undef CHECK_WORLDS
+
+
+void UGameplayReplicationGraph::PrintRepNodePolicies()
+{
+	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
+	if (!Enum)
+	{
+		return;
+	}
+
+	GLog->Logf(TEXT("===================================="));
+	GLog->Logf(TEXT("Game Replication Routing Policies"));
+	GLog->Logf(TEXT("===================================="));
+
+	for (auto It = ClassRepNodePolicies.CreateIterator(); It; ++It)
+	{
+		FObjectKey ObjKey = It.Key();
+		
+		EClassRepNodeMapping Mapping = It.Value();
+
+		GLog->Logf(TEXT("%-40s --> %s"), *GetNameSafe(ObjKey.ResolveObjectPtr()), *Enum->GetNameStringByValue(static_cast<uint32>(Mapping)));
+	}
+}
+
+void UGameplayReplicationGraph::PrintChannelStats(bool bReset)
+{
+	GLog->Logf(TEXT("===================================="));
+	GLog->Logf(TEXT("Game Replication Channel Stats"));
+	GLog->Logf(TEXT("===================================="));
+
+	ClassChannelStats.ValueSort([](const FChannelStats& A, const FChannelStats& B)
+	{
+		return A.NumOpened + A.NumClosed > B.NumOpened + B.NumClosed;
+	});
+
+	GLog->Logf(TEXT("%-40s %10s %10s"), TEXT("Class"), TEXT("Opened"), TEXT("Closed"));
+	for (const auto& StatsIt : ClassChannelStats)
+	{
+		GLog->Logf(TEXT("%-40s %10d %10d"), *GetNameSafe(StatsIt.Key.ResolveObjectPtr()), StatsIt.Value.NumOpened, StatsIt.Value.NumClosed);
+	}
+
+	if (bReset)
+	{
+		ClassChannelStats.Reset();
+	}
+}
+
+void UGameplayReplicationGraph::PrintAdaptiveFrequencies(bool bReset)
+{
+	GLog->Logf(TEXT("===================================="));
+	GLog->Logf(TEXT("Game Replication Adaptive Frequencies"));
+	GLog->Logf(TEXT("===================================="));
+
+	const float TickRate = NetDriver ? (float)NetDriver->GetNetServerMaxTickRate() : 30.f;
+
+	GLog->Logf(TEXT("%-40s %10s %10s %10s"), TEXT("Class"), TEXT("Current"), TEXT("Suggested"), TEXT("Samples"));
+	for (const auto& StatsIt : AdaptiveClassStats)
+	{
+		const UClass* Class = StatsIt.Key.ResolveObjectPtr();
+		const AActor* CDO = Class ? Class->GetDefaultObject<AActor>() : nullptr;
+		const double AveragePeriod = StatsIt.Value.ReplicationPeriodSum / FMath::Max(StatsIt.Value.NumSamples, 1);
+
+		GLog->Logf(TEXT("%-40s %10.2f %10.2f %10d"), *GetNameSafe(Class), CDO ? CDO->GetNetUpdateFrequency() : 0.f, TickRate / FMath::Max(AveragePeriod, 1.0), StatsIt.Value.NumSamples);
+	}
+
+	if (bReset)
+	{
+		AdaptiveClassStats.Reset();
+	}
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Console Commands
+// --------------------------------------------------------------------------------------------------------------------
+
+FAutoConsoleCommandWithWorldAndArgs PrintRepNodePolicyCmd(TEXT("GameRepGraph.PrintRouting"),TEXT("Prints how actor classes are routed to RepGraph nodes"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		for (TObjectIterator<UGameplayReplicationGraph> It; It; ++It)
+		{
+			It->PrintRepNodePolicies();
+		}
+	})
+);
+
+FAutoConsoleCommandWithWorldAndArgs PrintChannelStatsCmd(TEXT("GameRepGraph.PrintChannelStats"), TEXT("Prints how many actor channels were opened and closed per class. Pass 'reset' to reset the stats afterwards."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const bool bReset = Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase);
+		for (TObjectIterator<UGameplayReplicationGraph> It; It; ++It)
+		{
+			It->PrintChannelStats(bReset);
+		}
+	})
+);
+
+FAutoConsoleCommandWithWorldAndArgs PrintAdaptiveFrequenciesCmd(TEXT("GameRepGraph.PrintAdaptiveFrequencies"), TEXT("Prints the NetUpdateFrequency the adaptive frequency suggests per class. Pass 'reset' to reset the stats afterwards."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const bool bReset = Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase);
+		for (TObjectIterator<UGameplayReplicationGraph> It; It; ++It)
+		{
+			It->PrintAdaptiveFrequencies(bReset);
+		}
+	})
+);
+
+FAutoConsoleCommandWithWorldAndArgs ChangeFrequencyBucketsCmd(TEXT("GameRepGraph.FrequencyBuckets"), TEXT("Resets frequency bucket count."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray< FString >& Args, UWorld* World) 
+{
+	int32 Buckets = 1;
+	if (Args.Num() > 0)
+	{
+		LexTryParseString<int32>(Buckets, *Args[0]);
+	}
+
+	UE_LOG(LogGameRepGraph, Display, TEXT("Setting Frequency Buckets to %d"), Buckets);
+	for (TObjectIterator<UReplicationGraphNode_ActorListFrequencyBuckets> It; It; ++It)
+	{
+		UReplicationGraphNode_ActorListFrequencyBuckets* Node = *It;
+		Node->SetNonStreamingCollectionSize(Buckets);
+	}
+}));
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// UGameplayReplicationGraphConnection
+// --------------------------------------------------------------------------------------------------------------------
+
+void UGameplayReplicationGraphConnection::NotifyActorChannelAdded(AActor* Actor, UActorChannel* Channel)
+{
+	Super::NotifyActorChannelAdded(Actor, Channel);
+
+	if (UGameplayReplicationGraph* GameGraph = Cast<UGameplayReplicationGraph>(GetOuter()))
+	{
+		GameGraph->NotifyActorChannelOpened(Actor);
+	}
+}
+
+void UGameplayReplicationGraphConnection::NotifyActorChannelRemoved(AActor* Actor)
+{
+	Super::NotifyActorChannelRemoved(Actor);
+
+	if (UGameplayReplicationGraph* GameGraph = Cast<UGameplayReplicationGraph>(GetOuter()))
+	{
+		GameGraph->NotifyActorChannelClosed(Actor);
+	}
+}
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// UGameRepGraphNode_AlwaysRelevant_ForConnection
+// --------------------------------------------------------------------------------------------------------------------
+
+void UGameRepGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(
+	const FConnectionGatherActorListParameters& Params)
+{
+	UGameplayReplicationGraph* GameGraph = CastChecked<UGameplayReplicationGraph>(GetOuter());
+
+	ReplicationActorList.Reset();
+
+	// A viewer was added or removed (e.g. a splitscreen child connection disconnected)
+	if (CachedViewerStates.Num() != Params.Viewers.Num())
+	{
+		CachedViewerStates.SetNum(Params.Viewers.Num());
+		bCachedRelevantActorsDirty = true;
+	}
+
+	for (int32 ViewerIdx = 0; ViewerIdx < Params.Viewers.Num(); ++ViewerIdx)
+	{
+		const FNetViewer& CurViewer = Params.Viewers[ViewerIdx];
+
+		ReplicationActorList.ConditionalAdd(CurViewer.InViewer);
+		ReplicationActorList.ConditionalAdd(CurViewer.ViewTarget);
+
+		if (APlayerController* PC = Cast<APlayerController>(CurViewer.InViewer))
+		{
+			// 50% throttling of PlayerStates.
+			const bool bReplicatePS = (Params.ConnectionManager.ConnectionOrderNum % 2) == (Params.ReplicationFrameNum % 2);
+			if (bReplicatePS)
+			{
+				// Always return the player state to the owning player. Simulated proxy player states are handled by UGameRepGraphNode_PlayerStateFrequenceLimiter.
+				if (APlayerState* PS = PC->PlayerState)
+				{
+					if (!bInitializedPlayerState)
+					{
+						bInitializedPlayerState = true;
+						FConnectionReplicationActorInfo& ConnectionActorInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(PS);
+						ConnectionActorInfo.ReplicationPeriodFrame = 1;
+					}
+
+					ReplicationActorList.ConditionalAdd(PS);
+				}
+			}
+
+			APawn* PossessedPawn = PC->GetPawn();
+			ACharacter* Pawn = Cast<ACharacter>(PossessedPawn);
+			ACharacter* ViewTargetPawn = Cast<ACharacter>(CurViewer.ViewTarget);
+
+			// Only touch the cached relevant actors when the possessed pawn or the view target changed
+			FCachedViewerState& ViewerState = CachedViewerStates[ViewerIdx];
+			const bool bOwnershipChanged = ViewerState.Connection.Get() != CurViewer.Connection || ViewerState.Pawn.Get() != PossessedPawn;
+			if (bOwnershipChanged || ViewerState.ViewTarget.Get() != ViewTargetPawn)
+			{
+				FCachedAlwaysRelevantActorInfo& LastData = PastRelevantActorMap.FindOrAdd(CurViewer.Connection);
+
+				if (Pawn)
+				{
+					UpdateCachedRelevantActor(Params, Pawn, LastData.LastViewer);
+				}
+
+				if (ViewTargetPawn)
+				{
+					UpdateCachedRelevantActor(Params, ViewTargetPawn, LastData.LastViewTarget);
+				}
+
+				if (bOwnershipChanged)
+				{
+					// Owner-only actors owned by the controller or the old/new pawn may have changed their owning connection
+					GameGraph->NotifyActorOwnerChanged(PC);
+					GameGraph->NotifyActorOwnerChanged(ViewerState.Pawn.Get());
+				}
+
+				ViewerState.Connection = CurViewer.Connection;
+				ViewerState.Pawn = PossessedPawn;
+				ViewerState.ViewTarget = ViewTargetPawn;
+				bCachedRelevantActorsDirty = true;
+			}
+
+			if (Pawn && Pawn != CurViewer.ViewTarget)
+			{
+				ReplicationActorList.ConditionalAdd(Pawn);
+			}
+		}
+	}
+
+	if (bCachedRelevantActorsDirty)
+	{
+		CleanupCachedRelevantActors(PastRelevantActorMap);
+
+		// A disconnected connection is only removed once it has been garbage collected, keep cleaning up until then
+		bCachedRelevantActorsDirty = PastRelevantActorMap.Num() > Params.Viewers.Num();
+	}
+
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+
+	// Always relevant streaming level actors.
+	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
+	
+	TMap<FName, FActorRepListRefView>& AlwaysRelevantStreamingLevelActors = GameGraph->AlwaysRelevantStreamingLevelActors;
+
+	for (int32 Idx=AlwaysRelevantStreamingLevelsNeedingReplication.Num()-1; Idx >= 0; --Idx)
+	{
+		const FName& StreamingLevel = AlwaysRelevantStreamingLevelsNeedingReplication[Idx];
+
+		FActorRepListRefView* Ptr = AlwaysRelevantStreamingLevelActors.Find(StreamingLevel);
+		if (Ptr == nullptr)
+		{
+			// No always relevant lists for that level
+			UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING Removing %s from AlwaysRelevantStreamingLevelActors because FActorRepListRefView is null. %s "), *StreamingLevel.ToString(),  *Params.ConnectionManager.GetName());
+			AlwaysRelevantStreamingLevelsNeedingReplication.RemoveAtSwap(Idx, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		FActorRepListRefView& RepList = *Ptr;
+
+		if (RepList.Num() > 0)
+		{
+			bool bAllDormant = true;
+			for (FActorRepListType Actor : RepList)
+			{
+				FConnectionReplicationActorInfo& ConnectionActorInfo = ConnectionActorInfoMap.FindOrAdd(Actor);
+				if (ConnectionActorInfo.bDormantOnConnection == false)
+				{
+					bAllDormant = false;
+					break;
+				}
+			}
+
+			if (bAllDormant)
+			{
+				UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING All AlwaysRelevant Actors Dormant on StreamingLevel %s for %s. Removing list."), *StreamingLevel.ToString(), *Params.ConnectionManager.GetName());
+				AlwaysRelevantStreamingLevelsNeedingReplication.RemoveAtSwap(Idx, 1, EAllowShrinking::No);
+			}
+			else
+			{
+				UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING Adding always Actors on StreamingLevel %s for %s because it has at least one non dormant actor"), *StreamingLevel.ToString(), *Params.ConnectionManager.GetName());
+				Params.OutGatheredReplicationLists.AddReplicationActorList(RepList);
+			}
+		}
+		else
+		{
+			UE_LOG(LogGameRepGraph, Warning, TEXT("UGameRepGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection - empty RepList %s"), *Params.ConnectionManager.GetName());
+		}
+
+	}
+
+#if WITH_GAMEPLAY_DEBUGGER
+	if (GameplayDebugger)
+	{
+		ReplicationActorList.ConditionalAdd(GameplayDebugger);
+	}
+#endif
+}
+
+void UGameRepGraphNode_AlwaysRelevant_ForConnection::LogNode(
+	FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+	LogActorRepList(DebugInfo, NodeName, ReplicationActorList);
+
+	for (const FName& LevelName : AlwaysRelevantStreamingLevelsNeedingReplication)
+	{
+		UGameplayReplicationGraph* GameGraph = CastChecked<UGameplayReplicationGraph>(GetOuter());
+		if (FActorRepListRefView* RepList = GameGraph->AlwaysRelevantStreamingLevelActors.Find(LevelName))
+		{
+			LogActorRepList(DebugInfo, FString::Printf(TEXT("AlwaysRelevant StreamingLevel List: %s"), *LevelName.ToString()), *RepList);
+		}
+	}
+
+	DebugInfo.PopIndent();
+}
+
+void UGameRepGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityAdd(FName LevelName, UWorld* StreamingWorld)
+{
+	UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING Adding %s to AlwaysRelevantStreamingLevelActors for %s"), *LevelName.ToString(), *GetNameSafe(StreamingWorld));
+	AlwaysRelevantStreamingLevelsNeedingReplication.Add(LevelName);
+}
+
+void UGameRepGraphNode_AlwaysRelevant_ForConnection::OnClientLevelVisibilityRemove(FName LevelName)
+{
+	UE_CLOG(GameplayRepGraph::DisplayClientLevelStreaming > 0, LogGameRepGraph, Display, TEXT("CLIENTSTREAMING Removing %s from AlwaysRelevantStreamingLevelActors for %s"), *LevelName.ToString(), *GetNameSafe(GetOuter()));
+	AlwaysRelevantStreamingLevelsNeedingReplication.Remove(LevelName);
+}
+
+void UGameRepGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState()
 {
 	ReplicationActorList.Reset();
 	AlwaysRelevantStreamingLevelsNeedingReplication.Empty();
+
+	CachedViewerStates.Reset();
+	bCachedRelevantActorsDirty = true;
+}
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// UGameRepGraphNode_PlayerStateFrequencyLimiter
+// --------------------------------------------------------------------------------------------------------------------
+
+UGameRepGraphNode_PlayerStateFrequencyLimiter::UGameRepGraphNode_PlayerStateFrequencyLimiter()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UGameRepGraphNode_PlayerStateFrequencyLimiter::GatherActorListsForConnection(
+	const FConnectionGatherActorListParameters& Params)
+{
+	const int32 ListIdx = Params.ReplicationFrameNum % ReplicationActorLists.Num();
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorLists[ListIdx]);
+
+	if (ForceNetUpdateReplicationActorList.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(ForceNetUpdateReplicationActorList);
+	}	
+}
+
+void UGameRepGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+{
+	ReplicationActorLists.Reset();
+	ForceNetUpdateReplicationActorList.Reset();
+
+	ReplicationActorLists.AddDefaulted();
+	FActorRepListRefView* CurrentList = &ReplicationActorLists[0];
+
+	// We rebuild our lists of player states each frame. This is not as efficient as it could be but its the simplest way
+	// to handle players disconnecting and keeping the lists compact. If the lists were persistent we would need to defrag them as players left.
+	for (TActorIterator<APlayerState> It(GetWorld()); It; ++It)
+	{
+		APlayerState* PS = *It;
+		if (IsActorValidForReplicationGather(PS) == false)
+		{
+			continue;
+		}
+
+		if (CurrentList->Num() >= TargetActorsPerFrame)
+		{
+			ReplicationActorLists.AddDefaulted();
+			CurrentList = &ReplicationActorLists.Last(); 
+		}
+		
+		CurrentList->Add(PS);
+	}	
+}
+
+void UGameRepGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplicationGraphDebugInfo& DebugInfo,
+	const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();	
+
+	int32 i=0;
+	for (const FActorRepListRefView& List : ReplicationActorLists)
+	{
+		LogActorRepList(DebugInfo, FString::Printf(TEXT("Bucket[%d]"), i++), List);
+	}
+
+	DebugInfo.PopIndent();
+}
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// UGameRepGraphNode_InterestGroups
+// --------------------------------------------------------------------------------------------------------------------
+
+bool UGameRepGraphNode_InterestGroups::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	TArray<FName, TInlineAllocator<2>> Groups;
+	if (!ActorGroups.RemoveAndCopyValue(ActorInfo.Actor, Groups))
+	{
+		return false;
+	}
+
+	for (const FName& GroupName : Groups)
+	{
+		if (UReplicationGraphNode_ActorList* GroupNode = GroupNodes.FindRef(GroupName))
+		{
+			GroupNode->NotifyRemoveNetworkActor(ActorInfo, bWarnIfNotFound);
+		}
+	}
+
+	return true;
+}
+
+void UGameRepGraphNode_InterestGroups::NotifyResetAllNetworkActors()
+{
+	ActorGroups.Reset();
+
+	for (auto& GroupIt : GroupNodes)
+	{
+		GroupIt.Value->NotifyResetAllNetworkActors();
+	}
+}
+
+void UGameRepGraphNode_InterestGroups::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	const TArray<FName, TInlineAllocator<4>>* Subscriptions = ConnectionSubscriptions.Find(&Params.ConnectionManager);
+	if (Subscriptions == nullptr)
+	{
+		return;
+	}
+
+	for (const FName& GroupName : *Subscriptions)
+	{
+		if (UReplicationGraphNode_ActorList* GroupNode = GroupNodes.FindRef(GroupName))
+		{
+			GroupNode->GatherActorListsForConnection(Params);
+		}
+	}
+}
+
+void UGameRepGraphNode_InterestGroups::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+
+	for (const auto& GroupIt : GroupNodes)
+	{
+		GroupIt.Value->LogNode(DebugInfo, FString::Printf(TEXT("Group: %s"), *GroupIt.Key.ToString()));
+	}
+
+	DebugInfo.PopIndent();
+}
+
+void UGameRepGraphNode_InterestGroups::AddActorToGroup(const FNewReplicatedActorInfo& ActorInfo, FName GroupName)
+{
+	TArray<FName, TInlineAllocator<2>>& Groups = ActorGroups.FindOrAdd(ActorInfo.Actor);
+	if (Groups.Contains(GroupName))
+	{
+		return;
+	}
+
+	Groups.Add(GroupName);
+
+	TObjectPtr<UReplicationGraphNode_ActorList>& GroupNode = GroupNodes.FindOrAdd(GroupName);
+	if (GroupNode == nullptr)
+	{
+		GroupNode = CreateChildNode<UReplicationGraphNode_ActorList>();
+	}
+
+	GroupNode->NotifyAddNetworkActor(ActorInfo);
+}
+
+void UGameRepGraphNode_InterestGroups::RemoveActorFromGroup(const FNewReplicatedActorInfo& ActorInfo, FName GroupName)
+{
+	TArray<FName, TInlineAllocator<2>>* Groups = ActorGroups.Find(ActorInfo.Actor);
+	if (Groups == nullptr || Groups->RemoveSwap(GroupName) == 0)
+	{
+		return;
+	}
+
+	if (Groups->Num() == 0)
+	{
+		ActorGroups.Remove(ActorInfo.Actor);
+	}
+
+	if (UReplicationGraphNode_ActorList* GroupNode = GroupNodes.FindRef(GroupName))
+	{
+		GroupNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+}
+
+void UGameRepGraphNode_InterestGroups::SubscribeConnection(UNetReplicationGraphConnection* ConnectionManager, FName GroupName)
+{
+	if (ConnectionManager && !GroupName.IsNone())
+	{
+		ConnectionSubscriptions.FindOrAdd(ConnectionManager).AddUnique(GroupName);
+	}
+}
+
+void UGameRepGraphNode_InterestGroups::UnsubscribeConnection(UNetReplicationGraphConnection* ConnectionManager, FName GroupName)
+{
+	if (TArray<FName, TInlineAllocator<4>>* Subscriptions = ConnectionSubscriptions.Find(ConnectionManager))
+	{
+		Subscriptions->RemoveSwap(GroupName);
+		if (Subscriptions->Num() == 0)
+		{
+			ConnectionSubscriptions.Remove(ConnectionManager);
+		}
+	}
+}
+
+void UGameRepGraphNode_InterestGroups::RemoveConnection(UNetReplicationGraphConnection* ConnectionManager)
+{
+	ConnectionSubscriptions.Remove(ConnectionManager);
+}
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// UGameRepGraphNode_ActorPolicy_ForConnection
+// --------------------------------------------------------------------------------------------------------------------
+
+UGameRepGraphNode_ActorPolicy_ForConnection::UGameRepGraphNode_ActorPolicy_ForConnection()
+{
+	OcclusionTraceDelegate.BindUObject(this, &UGameRepGraphNode_ActorPolicy_ForConnection::OnOcclusionTraceDone);
+}
+
+bool UGameRepGraphNode_ActorPolicy_ForConnection::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	FActorPolicyState State;
+	if (!ActorStates.RemoveAndCopyValue(ActorInfo.Actor, State))
+	{
+		return false;
+	}
+
+	if (State.PendingTraceId != 0)
+	{
+		PendingOcclusionTraces.Remove(State.PendingTraceId);
+	}
+
+	return true;
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::NotifyResetAllNetworkActors()
+{
+	ActorStates.Reset();
+	PendingOcclusionTraces.Reset();
+	DeferredReplications.Reset();
+
+	// Stage the new world's actors as well
+	JoinFrame = 0;
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	UGameplayReplicationGraph* GameGraph = CastChecked<UGameplayReplicationGraph>(GetOuter());
+
+	LastGatherFrame = Params.ReplicationFrameNum;
+	if (JoinFrame == 0)
+	{
+		JoinFrame = Params.ReplicationFrameNum;
+	}
+
+	OcclusionTraceBudget = GameplayRepGraph::OcclusionMaxTracesPerFrame;
+	DistanceBandPeriodScale = GameGraph->GetGovernorPeriodScale();
+
+	RestoreDeferredReplications(Params);
+
+	UpdateSaturation(Params);
+
+	ClassBudgets.SetNum(GameGraph->GetNumClassBudgets());
+	for (FClassBudget& ClassBudget : ClassBudgets)
+	{
+		ClassBudget.Actors.Reset();
+	}
+
+	for (const auto& ActorList : Params.OutGatheredReplicationLists.GetLists(EActorRepListTypeFlags::Default))
+	{
+		for (FActorRepListType Actor : ActorList)
+		{
+			const FRepGraphClassPolicy* ClassPolicy = GameGraph->GetClassPolicy(Actor->GetClass());
+			if (ClassPolicy == nullptr || !ClassPolicy->HasConnectionPolicies())
+			{
+				continue;
+			}
+
+			// The connection's own actors keep the settings UGameRepGraphNode_AlwaysRelevant_ForConnection gave them
+			if (IsConnectionActor(Params, Actor))
+			{
+				continue;
+			}
+
+			FActorPolicyState& State = ActorStates.FindOrAdd(Actor);
+			if (State.LastAppliedFrame == Params.ReplicationFrameNum)
+			{
+				continue;
+			}
+
+			State.LastAppliedFrame = Params.ReplicationFrameNum;
+			ApplyActorPolicies(*GameGraph, Params, Actor, *ClassPolicy, State);
+		}
+	}
+
+	EnforceClassBudgets(Params);
+	LimitChannelOpens(Params);
+}
+
+bool UGameRepGraphNode_ActorPolicy_ForConnection::IsConnectionActor(const FConnectionGatherActorListParameters& Params, const AActor* Actor)
+{
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		if (Viewer.InViewer == Actor || Viewer.ViewTarget == Actor)
+		{
+			return true;
+		}
+
+		// Spectating or drone cameras view something else than the possessed pawn, which still needs to reach its player
+		if (const APlayerController* PC = Cast<APlayerController>(Viewer.InViewer))
+		{
+			if (PC->GetPawn() == Actor || PC->PlayerState == Actor)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
+{
+	DebugInfo.Log(NodeName);
+	DebugInfo.PushIndent();
+
+	int32 NumOccluded = 0;
+	int32 NumReducedLOD = 0;
+	for (const auto& StateIt : ActorStates)
+	{
+		NumOccluded += StateIt.Value.bOccluded ? 1 : 0;
+		NumReducedLOD += StateIt.Value.LODTier > 0 ? 1 : 0;
+	}
+
+	DebugInfo.Log(FString::Printf(TEXT("Actors: %d, Occluded: %d, Pending Occlusion Traces: %d, Reduced LOD: %d"), ActorStates.Num(), NumOccluded, PendingOcclusionTraces.Num(), NumReducedLOD));
+	DebugInfo.Log(FString::Printf(TEXT("Cull Distance Scale: %.2f, Saturation Cull Distance Scale: %.2f"), CullDistanceScale, SaturationCullDistanceScale));
+	DebugInfo.Log(FString::Printf(TEXT("Deferred Channel Opens: %d, Deferred By Class Budgets: %d"), NumDeferredChannelOpens, NumDeferredByClassBudgets));
+
+	DebugInfo.PopIndent();
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::ApplyActorPolicies(const UGameplayReplicationGraph& GameGraph, const FConnectionGatherActorListParameters& Params, AActor* Actor, const FRepGraphClassPolicy& ClassPolicy, FActorPolicyState& State)
+{
+	const FGlobalActorReplicationInfo& GlobalInfo = GraphGlobals->GlobalActorReplicationInfoMap->Get(Actor);
+	FConnectionReplicationActorInfo& ConnectionInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(Actor);
+
+	const bool bPreRelevant = ClassPolicy.HasCullDistancePolicies() && UpdateCullDistance(Params, Actor, ClassPolicy, GlobalInfo, ConnectionInfo);
+	const float ViewerDistanceSq = GetClosestViewerDistanceSquared(Params, GlobalInfo.WorldLocation);
+
+	uint32 ReplicationPeriodFrame = GlobalInfo.Settings.ReplicationPeriodFrame;
+
+	if (ClassPolicy.DistanceBands.Num() > 0 && GameplayRepGraph::EnableDistanceBands > 0)
+	{
+		ReplicationPeriodFrame = ClassPolicy.GetDistanceBandPeriod(ViewerDistanceSq);
+
+		// Full rate bands stay at full rate under the governor
+		if (ReplicationPeriodFrame > 1)
+		{
+			ReplicationPeriodFrame = FMath::RoundToInt(ReplicationPeriodFrame * DistanceBandPeriodScale);
+		}
+	}
+
+	if (ClassPolicy.LODTiers.Num() > 0)
+	{
+		State.LODTier = GameplayRepGraph::EnableLODTiers > 0 ? ClassPolicy.GetLODTier(ViewerDistanceSq) : 0;
+
+		uint16 FastSharedReplicationPeriodFrame = 1;
+		if (State.LODTier > 0)
+		{
+			// Distant tiers only get the full property set every so often, their movement keeps going out through the FastShared path
+			const FRepGraphClassPolicy::FLODTier& LODTier = ClassPolicy.LODTiers[State.LODTier - 1];
+			ReplicationPeriodFrame = FMath::Max(ReplicationPeriodFrame, LODTier.MinReplicationPeriodFrame);
+			FastSharedReplicationPeriodFrame = LODTier.FastSharedReplicationPeriodFrame;
+		}
+
+		SetFastSharedReplicationPeriod(ConnectionInfo, FastSharedReplicationPeriodFrame);
+	}
+
+	if (ClassPolicy.bOcclusionCulling && UpdateOcclusion(Params, Actor, GlobalInfo, ConnectionInfo, State))
+	{
+		ReplicationPeriodFrame *= ClassPolicy.OccludedReplicationPeriodScale;
+	}
+
+	if (ClassPolicy.bViewCone && GameplayRepGraph::EnableViewCone > 0)
+	{
+		const float OffScreenFactor = GetOffScreenFactor(Params, GlobalInfo.WorldLocation, ClassPolicy.ViewConeCosHalfAngle);
+		if (OffScreenFactor > 0.f)
+		{
+			// The view cone may only stretch the period up to its cap, never shorten what the other policies came up with
+			const float PeriodScale = 1.f + OffScreenFactor * (ClassPolicy.OffScreenReplicationPeriodScale - 1);
+			const uint32 MaxReplicationPeriodFrame = FMath::Max<uint32>(ReplicationPeriodFrame, ClassPolicy.OffScreenMaxReplicationPeriodFrame);
+			ReplicationPeriodFrame = FMath::Min<uint32>(FMath::RoundToInt(ReplicationPeriodFrame * PeriodScale), MaxReplicationPeriodFrame);
+		}
+	}
+
+	if (bPreRelevant)
+	{
+		ReplicationPeriodFrame = FMath::Max<uint32>(ReplicationPeriodFrame, ClassPolicy.PredictiveReplicationPeriodFrame);
+	}
+
+	SetReplicationPeriod(ConnectionInfo, ReplicationPeriodFrame);
+
+	// Clean actors wait for their next change before they take up a prioritization slot, new channels still need their initial replication.
+	// Skipped actors never reach the point where the engine refreshes their channel timeout, so their channel is kept open here.
+	if (ClassPolicy.bReplicateOnlyWhenDirty && GameplayRepGraph::SkipCleanActors > 0 && ConnectionInfo.Channel
+		&& ConnectionInfo.NextReplicationFrameNum <= Params.ReplicationFrameNum && !GameGraph.IsActorDirtySince(Actor, ConnectionInfo.LastRepFrameNum))
+	{
+		ConnectionInfo.NextReplicationFrameNum = Params.ReplicationFrameNum + 1;
+		ConnectionInfo.ActorChannelCloseFrameNum = FMath::Max<uint32>(ConnectionInfo.ActorChannelCloseFrameNum, Params.ReplicationFrameNum + ReplicationPeriodFrame + ConnectionInfo.ActorChannelFrameTimeout);
+	}
+
+	// Deactivated pooled actors only finish going dormant on connections that already have them, nobody else needs a hidden actor.
+	// Deferred every frame until the actor is activated again, ForceNetUpdate would get past a pushed schedule.
+	if (ClassPolicy.bPooledActors && ConnectionInfo.Channel == nullptr && GameGraph.IsPooledActorDeactivated(Actor))
+	{
+		DeferReplication(Params, Actor);
+		return;
+	}
+
+	// Queue actors that replicate this frame up for their class budget. ForceNetUpdate gets past their schedule, out of range actors never replicate.
+	const float CullDistanceSq = ConnectionInfo.GetCullDistanceSquared();
+	if (ClassBudgets.IsValidIndex(ClassPolicy.BudgetIndex) && GameplayRepGraph::EnableClassBudgets > 0 && !ConnectionInfo.bDormantOnConnection
+		&& (ConnectionInfo.NextReplicationFrameNum <= Params.ReplicationFrameNum || GlobalInfo.ForceNetUpdateFrame > ConnectionInfo.LastRepFrameNum)
+		&& (CullDistanceSq <= 0.f || ViewerDistanceSq <= CullDistanceSq))
+	{
+		// Closer, higher priority and more starved actors go first
+		const uint32 FramesSinceLastRep = Params.ReplicationFrameNum - ConnectionInfo.LastRepFrameNum;
+		const float SortKey = ViewerDistanceSq
+			/ FMath::Square(FMath::Max(Actor->GetNetPriority(), UE_KINDA_SMALL_NUMBER))
+			/ FMath::Square(1.f + FramesSinceLastRep);
+
+		FClassBudget& ClassBudget = ClassBudgets[ClassPolicy.BudgetIndex];
+		ClassBudget.MaxActorsPerFrame = ClassPolicy.MaxActorsPerFrame;
+		ClassBudget.Actors.Emplace(SortKey, Actor);
+	}
+}
+
+bool UGameRepGraphNode_ActorPolicy_ForConnection::UpdateOcclusion(const FConnectionGatherActorListParameters& Params, AActor* Actor, const FGlobalActorReplicationInfo& GlobalInfo, const FConnectionReplicationActorInfo& ConnectionInfo, FActorPolicyState& State)
+{
+	// Splitscreen connections would need a trace per viewer, treat everything as visible for them
+	if (GameplayRepGraph::EnableOcclusionCulling == 0 || Params.Viewers.Num() != 1)
+	{
+		State.NumOccludedResults = 0;
+		State.bOccluded = false;
+		return false;
+	}
+
+	const FNetViewer& Viewer = Params.Viewers[0];
+	const FVector::FReal DistSq = FVector::DistSquared(Viewer.ViewLocation, GlobalInfo.WorldLocation);
+
+	// Close actors are always treated as visible, actors beyond the cull distance won't replicate anyway
+	const float CullDistSq = ConnectionInfo.GetCullDistanceSquared();
+	if (DistSq < FMath::Square(GameplayRepGraph::OcclusionMinDistance) || (CullDistSq > 0.f && DistSq > CullDistSq))
+	{
+		State.NumOccludedResults = 0;
+		State.bOccluded = false;
+		return false;
+	}
+
+	// Keep using the cached result until it expires. If a trace takes longer than that, it gets replaced.
+	UWorld* World = GetWorld();
+	if (World && State.OcclusionExpiryFrame <= Params.ReplicationFrameNum && OcclusionTraceBudget > 0)
+	{
+		--OcclusionTraceBudget;
+
+		if (State.PendingTraceId != 0)
+		{
+			PendingOcclusionTraces.Remove(State.PendingTraceId);
+		}
+
+		// 0 means no trace in flight
+		if (++LastOcclusionTraceId == 0)
+		{
+			++LastOcclusionTraceId;
+		}
+
+		State.PendingTraceId = LastOcclusionTraceId;
+		State.OcclusionExpiryFrame = Params.ReplicationFrameNum + FMath::Max(GameplayRepGraph::OcclusionCacheFrames, 1);
+		PendingOcclusionTraces.Add(State.PendingTraceId, Actor);
+
+		// Only level geometry occludes, other pawns and movable props don't
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GameRepGraphOcclusion), false);
+		QueryParams.AddIgnoredActor(Actor);
+
+		World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Viewer.ViewLocation, GlobalInfo.WorldLocation,
+			FCollisionObjectQueryParams(ECC_WorldStatic), QueryParams, &OcclusionTraceDelegate, State.PendingTraceId);
+	}
+
+	return State.bOccluded;
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::OnOcclusionTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	AActor* Actor = nullptr;
+	if (!PendingOcclusionTraces.RemoveAndCopyValue(TraceDatum.UserData, Actor))
+	{
+		return;
+	}
+
+	FActorPolicyState* State = ActorStates.Find(Actor);
+	if (State == nullptr || State->PendingTraceId != TraceDatum.UserData)
+	{
+		return;
+	}
+
+	State->PendingTraceId = 0;
+	State->OcclusionExpiryFrame = LastGatherFrame + FMath::Max(GameplayRepGraph::OcclusionCacheFrames, 1);
+
+	const bool bBlocked = TraceDatum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+	if (bBlocked)
+	{
+		State->NumOccludedResults = (uint8)FMath::Min<int32>(State->NumOccludedResults + 1, MAX_uint8);
+		State->bOccluded = State->NumOccludedResults >= GameplayRepGraph::OcclusionResultsRequired;
+	}
+	else
+	{
+		// Visible results apply right away, so an actor coming into view is never held back
+		State->NumOccludedResults = 0;
+		State->bOccluded = false;
+	}
+}
+
+bool UGameRepGraphNode_ActorPolicy_ForConnection::UpdateCullDistance(const FConnectionGatherActorListParameters& Params, AActor* Actor, const FRepGraphClassPolicy& ClassPolicy, const FGlobalActorReplicationInfo& GlobalInfo, FConnectionReplicationActorInfo& ConnectionInfo) const
+{
+	const float GlobalCullDistance = GlobalInfo.Settings.GetCullDistance();
+	if (GlobalCullDistance <= 0.f)
+	{
+		return false;
+	}
+
+	// The global cull distance covers the class' largest scale and extension, bring it back down to this connection's
+	const float BaseCullDistance = FMath::Max(GlobalCullDistance - ClassPolicy.GetCullDistanceExtension(), 0.f) / ClassPolicy.MaxCullDistanceScale;
+	float CullDistance = BaseCullDistance * FMath::Min(CullDistanceScale, ClassPolicy.MaxCullDistanceScale);
+	if (ClassPolicy.bShrinkCullDistanceWhenSaturated)
+	{
+		CullDistance *= SaturationCullDistanceScale;
+	}
+
+	// Actors with an open channel only leave once they're past the exit margin
+	const float CullDistanceSq = FMath::Square(ConnectionInfo.Channel ? CullDistance + ClassPolicy.CullDistanceExitMargin : CullDistance);
+	ConnectionInfo.SetCullDistanceSquared(CullDistanceSq);
+
+	if (!ClassPolicy.bPredictiveRelevancy || GameplayRepGraph::EnablePredictiveRelevancy == 0)
+	{
+		return false;
+	}
+
+	const float MaxPredictiveDistanceSq = FMath::Square(CullDistance + ClassPolicy.PredictiveMaxDistance);
+	const FVector PredictedActorLocation = GlobalInfo.WorldLocation + Actor->GetVelocity() * ClassPolicy.PredictiveLookahead;
+
+	bool bPreRelevant = false;
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const FVector::FReal DistSq = FVector::DistSquared(Viewer.ViewLocation, GlobalInfo.WorldLocation);
+		if (DistSq <= CullDistanceSq)
+		{
+			// Already relevant to this viewer
+			return false;
+		}
+
+		if (bPreRelevant || DistSq > MaxPredictiveDistanceSq)
+		{
+			continue;
+		}
+
+		const FVector ViewerVelocity = Viewer.ViewTarget ? Viewer.ViewTarget->GetVelocity() : FVector::ZeroVector;
+		const FVector PredictedViewLocation = Viewer.ViewLocation + ViewerVelocity * ClassPolicy.PredictiveLookahead;
+		bPreRelevant = FVector::DistSquared(PredictedViewLocation, PredictedActorLocation) <= CullDistanceSq;
+	}
+
+	if (bPreRelevant)
+	{
+		ConnectionInfo.SetCullDistanceSquared(FMath::Max(MaxPredictiveDistanceSq, CullDistanceSq));
+	}
+
+	return bPreRelevant;
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::UpdateSaturation(const FConnectionGatherActorListParameters& Params)
+{
+	UNetConnection* NetConnection = Params.ConnectionManager.NetConnection;
+	if (GameplayRepGraph::EnableSaturationCullDistance == 0 || NetConnection == nullptr)
+	{
+		SaturationCullDistanceScale = 1.f;
+		NumSaturatedFrames = 0;
+		NumClearFrames = 0;
+		return;
+	}
+
+	if (!NetConnection->IsNetReady(false))
+	{
+		NumClearFrames = 0;
+		if (++NumSaturatedFrames >= FMath::Max(GameplayRepGraph::SaturationShrinkFrames, 1))
+		{
+			NumSaturatedFrames = 0;
+			SaturationCullDistanceScale = FMath::Max(SaturationCullDistanceScale - GameplayRepGraph::SaturationStepScale, FMath::Clamp(GameplayRepGraph::SaturationMinCullDistanceScale, 0.f, 1.f));
+		}
+	}
+	else
+	{
+		// Recover slower than we shrink, so a connection on the edge doesn't flip back and forth every few frames
+		NumSaturatedFrames = 0;
+		if (++NumClearFrames >= FMath::Max(GameplayRepGraph::SaturationRecoverFrames, 1))
+		{
+			NumClearFrames = 0;
+			SaturationCullDistanceScale = FMath::Min(SaturationCullDistanceScale + GameplayRepGraph::SaturationStepScale, 1.f);
+		}
+	}
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::EnforceClassBudgets(const FConnectionGatherActorListParameters& Params)
+{
+	NumDeferredByClassBudgets = 0;
+
+	for (FClassBudget& ClassBudget : ClassBudgets)
+	{
+		if (ClassBudget.Actors.Num() <= ClassBudget.MaxActorsPerFrame)
+		{
+			continue;
+		}
+
+		ClassBudget.Actors.Sort([](const TPair<float, AActor*>& A, const TPair<float, AActor*>& B) { return A.Key < B.Key; });
+
+		// Pushing the schedule wouldn't hold back actors with a pending ForceNetUpdate
+		for (int32 Idx = ClassBudget.MaxActorsPerFrame; Idx < ClassBudget.Actors.Num(); ++Idx)
+		{
+			DeferReplication(Params, ClassBudget.Actors[Idx].Value);
+			++NumDeferredByClassBudgets;
+		}
+	}
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::LimitChannelOpens(const FConnectionGatherActorListParameters& Params)
+{
+	NumDeferredChannelOpens = 0;
+
+	int32 MaxChannelOpens = GameplayRepGraph::MaxChannelOpensPerFrame > 0 ? GameplayRepGraph::MaxChannelOpensPerFrame : MAX_int32;
+
+	// Joining connections start with nearby actors, the allowed distance grows to unlimited by the end of the ramp
+	const uint32 JoinRampFrames = GameplayRepGraph::EnableJoinStaging > 0 ? (uint32)FMath::Max(GameplayRepGraph::JoinRampFrames, 0) : 0;
+	const uint32 FramesSinceJoin = Params.ReplicationFrameNum - JoinFrame;
+	const bool bJoining = FramesSinceJoin < JoinRampFrames;
+
+	float JoinDistanceSq = TNumericLimits<float>::Max();
+	UGameplayReplicationGraph* GameGraph = CastChecked<UGameplayReplicationGraph>(GetOuter());
+	if (bJoining)
+	{
+		const float RampAlpha = (float)FramesSinceJoin / JoinRampFrames;
+		JoinDistanceSq = FMath::Square(GameplayRepGraph::JoinNearDistance / (1.f - RampAlpha));
+		MaxChannelOpens = FMath::Min(MaxChannelOpens, GameGraph->GetJoinChannelOpenBudget());
+	}
+
+	if (MaxChannelOpens == MAX_int32)
+	{
+		return;
+	}
+
+	PendingChannelOpens.Reset();
+
+	for (const auto& ActorList : Params.OutGatheredReplicationLists.GetLists(EActorRepListTypeFlags::Default))
+	{
+		for (FActorRepListType Actor : ActorList)
+		{
+			// Only actors that would open a channel this frame, ForceNetUpdate gets past their schedule
+			const FGlobalActorReplicationInfo& GlobalInfo = GraphGlobals->GlobalActorReplicationInfoMap->Get(Actor);
+			const FConnectionReplicationActorInfo* ConnectionInfo = Params.ConnectionManager.ActorInfoMap.Find(Actor);
+			if (ConnectionInfo && (ConnectionInfo->Channel != nullptr || ConnectionInfo->bDormantOnConnection
+				|| (ConnectionInfo->NextReplicationFrameNum > Params.ReplicationFrameNum && GlobalInfo.ForceNetUpdateFrame <= ConnectionInfo->LastRepFrameNum)))
+			{
+				continue;
+			}
+
+			if (IsConnectionActor(Params, Actor))
+			{
+				continue;
+			}
+
+			// Actors outside of their cull distance never open a channel, they'd only take up slots of actors that do
+			const float CullDistanceSq = ConnectionInfo ? ConnectionInfo->GetCullDistanceSquared() : GlobalInfo.Settings.GetCullDistanceSquared();
+			const float DistanceSq = CullDistanceSq > 0.f ? GetClosestViewerDistanceSquared(Params, GlobalInfo.WorldLocation) : 0.f;
+			if (DistanceSq > CullDistanceSq && CullDistanceSq > 0.f)
+			{
+				continue;
+			}
+
+			// Actors without a cull distance (always relevant, e.g. the GameState) go first, then by distance scaled down by NetPriority
+			if (DistanceSq > JoinDistanceSq)
+			{
+				DeferReplication(Params, Actor);
+				++NumDeferredChannelOpens;
+				continue;
+			}
+
+			PendingChannelOpens.Emplace(DistanceSq / FMath::Square(FMath::Max(Actor->GetNetPriority(), UE_KINDA_SMALL_NUMBER)), Actor);
+		}
+	}
+
+	if (bJoining)
+	{
+		// Only the opens that actually go through this frame: in range, within the join distance and within this frame's limit
+		const int32 NumAllowedChannelOpens = FMath::Min(PendingChannelOpens.Num(), MaxChannelOpens);
+		GameGraph->ConsumeJoinChannelOpenBudget(NumAllowedChannelOpens);
+	}
+
+	if (PendingChannelOpens.Num() <= MaxChannelOpens)
+	{
+		return;
+	}
+
+	PendingChannelOpens.Sort([](const TPair<float, AActor*>& A, const TPair<float, AActor*>& B) { return A.Key < B.Key; });
+
+	for (int32 Idx = MaxChannelOpens; Idx < PendingChannelOpens.Num(); ++Idx)
+	{
+		DeferReplication(Params, PendingChannelOpens[Idx].Value);
+		++NumDeferredChannelOpens;
+	}
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::DeferReplication(const FConnectionGatherActorListParameters& Params, AActor* Actor)
+{
+	FConnectionReplicationActorInfo& ConnectionInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(Actor);
+
+	// The cull distance is checked after ForceNetUpdate and the schedule, a tiny one holds the actor back no matter what. Restored next frame.
+	if (!DeferredReplications.Contains(Actor))
+	{
+		DeferredReplications.Add(Actor, ConnectionInfo.GetCullDistanceSquared());
+	}
+
+	ConnectionInfo.SetCullDistanceSquared(1.f);
+
+	// Being culled for a frame must not close an open channel
+	if (ConnectionInfo.Channel)
+	{
+		ConnectionInfo.ActorChannelCloseFrameNum = FMath::Max<uint32>(ConnectionInfo.ActorChannelCloseFrameNum, Params.ReplicationFrameNum + 1 + ConnectionInfo.ActorChannelFrameTimeout);
+	}
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::RestoreDeferredReplications(const FConnectionGatherActorListParameters& Params)
+{
+	for (const auto& DeferredIt : DeferredReplications)
+	{
+		if (FConnectionReplicationActorInfo* ConnectionInfo = Params.ConnectionManager.ActorInfoMap.Find(DeferredIt.Key))
+		{
+			ConnectionInfo->SetCullDistanceSquared(DeferredIt.Value);
+		}
+	}
+
+	DeferredReplications.Reset();
+}
+
+float UGameRepGraphNode_ActorPolicy_ForConnection::GetClosestViewerDistanceSquared(const FConnectionGatherActorListParameters& Params, const FVector& Location)
+{
+	float SmallestDistanceSq = TNumericLimits<float>::Max();
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		SmallestDistanceSq = FMath::Min<float>(SmallestDistanceSq, (float)FVector::DistSquared(Viewer.ViewLocation, Location));
+	}
+
+	return SmallestDistanceSq;
+}
+
+float UGameRepGraphNode_ActorPolicy_ForConnection::GetOffScreenFactor(const FConnectionGatherActorListParameters& Params, const FVector& Location, float CosHalfAngle)
+{
+	float OffScreenFactor = 1.f;
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const FVector ToActor = Location - Viewer.ViewLocation;
+		const FVector::FReal DistSq = ToActor.SizeSquared();
+		if (DistSq < FMath::Square(GameplayRepGraph::ViewConeMinDistance))
+		{
+			return 0.f;
+		}
+
+		const float Dot = (float)FVector::DotProduct(Viewer.ViewDir, ToActor * FMath::InvSqrt(DistSq));
+		if (Dot >= CosHalfAngle)
+		{
+			return 0.f;
+		}
+
+		// 0 at the edge of the cone, 1 right behind the viewer
+		OffScreenFactor = FMath::Min(OffScreenFactor, (CosHalfAngle - Dot) / FMath::Max(CosHalfAngle + 1.f, UE_KINDA_SMALL_NUMBER));
+	}
+
+	return FMath::Clamp(OffScreenFactor, 0.f, 1.f);
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::SetReplicationPeriod(FConnectionReplicationActorInfo& ConnectionInfo, uint32 ReplicationPeriodFrame)
+{
+	ReplicationPeriodFrame = FMath::Max<uint32>(ReplicationPeriodFrame, 1);
+
+	if (ReplicationPeriodFrame < ConnectionInfo.ReplicationPeriodFrame)
+	{
+		// Don't keep waiting on the longer period the actor was scheduled with
+		ConnectionInfo.NextReplicationFrameNum = FMath::Min<uint32>(ConnectionInfo.NextReplicationFrameNum, ConnectionInfo.LastRepFrameNum + ReplicationPeriodFrame);
+	}
+
+	ConnectionInfo.ReplicationPeriodFrame = ReplicationPeriodFrame;
+}
+
+void UGameRepGraphNode_ActorPolicy_ForConnection::SetFastSharedReplicationPeriod(FConnectionReplicationActorInfo& ConnectionInfo, uint16 ReplicationPeriodFrame)
+{
+	ReplicationPeriodFrame = FMath::Max<uint16>(ReplicationPeriodFrame, 1);
+
+	if (ReplicationPeriodFrame < ConnectionInfo.FastPath_ReplicationPeriodFrame)
+	{
+		// Don't keep waiting on the longer period the actor was scheduled with
+		ConnectionInfo.FastPath_NextReplicationFrameNum = FMath::Min<uint32>(ConnectionInfo.FastPath_NextReplicationFrameNum, ConnectionInfo.FastPath_LastRepFrameNum + ReplicationPeriodFrame);
+	}
+
+	ConnectionInfo.FastPath_ReplicationPeriodFrame = ReplicationPeriodFrame;
+}
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// UGameRepGraphNode_GridSpatialization2D
+// --------------------------------------------------------------------------------------------------------------------
+
+void UGameRepGraphNode_GridSpatialization2D::NotifyResetAllNetworkActors()
+{
+	Super::NotifyResetAllNetworkActors();
+
+	CachedGathers.Reset();
+	RemovedActors.Reset();
+	SharedGathers.Reset();
+	CohortSizes.Reset();
+	LastCohortSizes.Reset();
+}
+
+void UGameRepGraphNode_GridSpatialization2D::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	const int32 NumSlices = GameplayRepGraph::GatherTimeSlices;
+	if (NumSlices <= 1 && CachedGathers.Num() > 0)
+	{
+		CachedGathers.Reset();
+		RemovedActors.Reset();
+	}
+
+	// Once per frame, forget removed actors no cached gather can reference anymore and start over with the shared gathers
+	if (LastGatherFrame != Params.ReplicationFrameNum)
+	{
+		LastGatherFrame = Params.ReplicationFrameNum;
+		for (auto It = RemovedActors.CreateIterator(); It; ++It)
+		{
+			if (Params.ReplicationFrameNum - It.Value() > (uint32)NumSlices + 1)
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		SharedGathers.Reset();
+		Swap(LastCohortSizes, CohortSizes);
+		CohortSizes.Reset();
+	}
+
+	// Only cohorts that had more than one member last frame can share a gather, everyone else gets by with the cheap cohort hash
+	FCohortKey CohortKey;
+	const FCohortKey* Cohort = nullptr;
+	uint32 CohortHash = 0;
+	if (GameplayRepGraph::EnableSharedGather > 0 && GetCohortHash(Params, CohortHash))
+	{
+		CohortSizes.FindOrAdd(CohortHash)++;
+
+		const int32* LastCohortSize = LastCohortSizes.Find(CohortHash);
+		if (LastCohortSize && *LastCohortSize >= 2)
+		{
+			BuildCohortKey(Params, CohortHash, CohortKey);
+			Cohort = &CohortKey;
+		}
+	}
+
+	if (NumSlices <= 1)
+	{
+		GatherShared(Params, Cohort);
+		return;
+	}
+
+	FCachedGather& CachedGather = CachedGathers.FindOrAdd(&Params.ConnectionManager);
+
+	// Connections are spread evenly across the slices by their order, a cached gather is never older than one full cycle and a frame.
+	// Members of a shared cohort are spread by their cohort instead, so they full gather on the same frame and can share it.
+	// Every NumSlices full gathers the phase moves on by a frame, so the frequency bucket due on a connection's slice rotates
+	// through all buckets, no matter whether the bucket count shares a factor with the slice count.
+	const uint32 BasePhase = Cohort ? Cohort->Hash : (uint32)Params.ConnectionManager.ConnectionOrderNum;
+	const uint32 SlicePhase = (BasePhase % NumSlices + Params.ReplicationFrameNum / (NumSlices * NumSlices)) % NumSlices;
+	const bool bFullGather = CachedGather.LastFullGatherFrame == 0
+		|| (Params.ReplicationFrameNum + SlicePhase) % NumSlices == 0
+		|| Params.ReplicationFrameNum - CachedGather.LastFullGatherFrame > (uint32)NumSlices;
+
+	if (bFullGather)
+	{
+		const int32 NumDefaultLists = Params.OutGatheredReplicationLists.GetLists(EActorRepListTypeFlags::Default).Num();
+		const int32 NumFastSharedLists = Params.OutGatheredReplicationLists.GetLists(EActorRepListTypeFlags::FastShared).Num();
+
+		GatherShared(Params, Cohort);
+
+		CachedGather.DefaultActors.Reset();
+		CachedGather.FastSharedActors.Reset();
+		CachedGather.LastFullGatherFrame = Params.ReplicationFrameNum;
+		CachedGather.bChannelsKeptAlive = false;
+
+		TSet<AActor*> CopiedActors;
+		CopyGatheredLists(Params, EActorRepListTypeFlags::Default, NumDefaultLists, CachedGather.DefaultActors, CopiedActors);
+		CopyGatheredLists(Params, EActorRepListTypeFlags::FastShared, NumFastSharedLists, CachedGather.FastSharedActors, CopiedActors);
+		return;
+	}
+
+	if (RemovedActors.Num() > 0)
+	{
+		TArray<AActor*, TInlineAllocator<8>> StaleActors;
+		for (FActorRepListType Actor : CachedGather.DefaultActors)
+		{
+			if (RemovedActors.Contains(Actor))
+			{
+				StaleActors.Add(Actor);
+			}
+		}
+
+		for (AActor* StaleActor : StaleActors)
+		{
+			CachedGather.DefaultActors.RemoveFast(StaleActor);
+		}
+
+		StaleActors.Reset();
+		for (FActorRepListType Actor : CachedGather.FastSharedActors)
+		{
+			if (RemovedActors.Contains(Actor))
+			{
+				StaleActors.Add(Actor);
+			}
+		}
+
+		for (AActor* StaleActor : StaleActors)
+		{
+			CachedGather.FastSharedActors.RemoveFast(StaleActor);
+		}
+	}
+
+	// The cached actors aren't gathered for the default path until the next slice, which doesn't refresh their channel timeout anymore
+	if (!CachedGather.bChannelsKeptAlive)
+	{
+		CachedGather.bChannelsKeptAlive = true;
+
+		const uint32 NextFullGatherFrame = CachedGather.LastFullGatherFrame + NumSlices + 1;
+		KeepCachedChannelsAlive(Params, CachedGather.DefaultActors, NextFullGatherFrame);
+		KeepCachedChannelsAlive(Params, CachedGather.FastSharedActors, NextFullGatherFrame);
+	}
+
+	// Only the FastShared path looks at these, full replication waits for the connection's next slice
+	Params.OutGatheredReplicationLists.AddReplicationActorList(CachedGather.DefaultActors, EActorRepListTypeFlags::FastShared);
+	Params.OutGatheredReplicationLists.AddReplicationActorList(CachedGather.FastSharedActors, EActorRepListTypeFlags::FastShared);
+}
+
+void UGameRepGraphNode_GridSpatialization2D::NotifyActorRemoved(AActor* Actor)
+{
+	if (CachedGathers.Num() > 0)
+	{
+		RemovedActors.Add(Actor, LastGatherFrame);
+	}
+
+	// A removed actor must not be handed out by a shared gather of this frame anymore
+	if (SharedGathers.Num() > 0)
+	{
+		for (TPair<FCohortKey, FSharedGather>& SharedGather : SharedGathers)
+		{
+			SharedGather.Value.DefaultActors.RemoveFast(Actor);
+			SharedGather.Value.FastSharedActors.RemoveFast(Actor);
+		}
+	}
+}
+
+void UGameRepGraphNode_GridSpatialization2D::RemoveConnection(UNetReplicationGraphConnection* ConnectionManager)
+{
+	CachedGathers.Remove(ConnectionManager);
+}
+
+void UGameRepGraphNode_GridSpatialization2D::GatherShared(const FConnectionGatherActorListParameters& Params, const FCohortKey* CohortKey)
+{
+	if (CohortKey == nullptr)
+	{
+		Super::GatherActorListsForConnection(Params);
+		return;
+	}
+
+	// Every member regularly runs its own gather, so the grid's per-connection dormancy bookkeeping catches up.
+	// Time-sliced members only get here once per slice, so they count slices instead of frames.
+	const int32 RefreshFrames = FMath::Max(GameplayRepGraph::SharedGatherRefreshFrames, 1);
+	const uint32 NumSlices = FMath::Max(GameplayRepGraph::GatherTimeSlices, 1);
+	const bool bRefresh = (Params.ReplicationFrameNum / NumSlices + Params.ConnectionManager.ConnectionOrderNum) % RefreshFrames == 0;
+
+	if (bRefresh)
+	{
+		Super::GatherActorListsForConnection(Params);
+		return;
+	}
+
+	if (const FSharedGather* SharedGather = SharedGathers.Find(*CohortKey))
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(SharedGather->DefaultActors, EActorRepListTypeFlags::Default);
+		Params.OutGatheredReplicationLists.AddReplicationActorList(SharedGather->FastSharedActors, EActorRepListTypeFlags::FastShared);
+		return;
+	}
+
+	const int32 NumDefaultLists = Params.OutGatheredReplicationLists.GetLists(EActorRepListTypeFlags::Default).Num();
+	const int32 NumFastSharedLists = Params.OutGatheredReplicationLists.GetLists(EActorRepListTypeFlags::FastShared).Num();
+
+	Super::GatherActorListsForConnection(Params);
+
+	FSharedGather& SharedGather = SharedGathers.Add(*CohortKey);
+	TSet<AActor*> CopiedActors;
+	CopyGatheredLists(Params, EActorRepListTypeFlags::Default, NumDefaultLists, SharedGather.DefaultActors, CopiedActors);
+	CopyGatheredLists(Params, EActorRepListTypeFlags::FastShared, NumFastSharedLists, SharedGather.FastSharedActors, CopiedActors);
+}
+
+bool UGameRepGraphNode_GridSpatialization2D::GetCohortHash(const FConnectionGatherActorListParameters& Params, uint32& OutCohortHash)
+{
+	// Splitscreen connections are never shared
+	if (Params.Viewers.Num() != 1)
+	{
+		return false;
+	}
+
+	const FNetViewer& Viewer = Params.Viewers[0];
+
+	// Order independent, the set is iterated in whatever order the levels became visible
+	uint32 LevelsHash = Params.ClientVisibleLevelNamesRef.Num();
+	for (const FName& LevelName : Params.ClientVisibleLevelNamesRef)
+	{
+		LevelsHash ^= GetTypeHash(LevelName);
+	}
+
+	OutCohortHash = HashCombine(HashCombine(GetTypeHash(TObjectKey<AActor>(Viewer.ViewTarget)), GetTypeHash(GetCohortLocation(Viewer))), LevelsHash);
+	return true;
+}
+
+void UGameRepGraphNode_GridSpatialization2D::BuildCohortKey(const FConnectionGatherActorListParameters& Params, uint32 CohortHash, FCohortKey& OutCohortKey)
+{
+	const FNetViewer& Viewer = Params.Viewers[0];
+
+	OutCohortKey.ViewTarget = Viewer.ViewTarget;
+	OutCohortKey.Location = GetCohortLocation(Viewer);
+	OutCohortKey.Hash = CohortHash;
+
+	OutCohortKey.VisibleLevels.Reset(Params.ClientVisibleLevelNamesRef.Num());
+	for (const FName& LevelName : Params.ClientVisibleLevelNamesRef)
+	{
+		OutCohortKey.VisibleLevels.Add(LevelName);
+	}
+	OutCohortKey.VisibleLevels.Sort(FNameFastLess());
+}
+
+FIntVector UGameRepGraphNode_GridSpatialization2D::GetCohortLocation(const FNetViewer& Viewer)
+{
+	const float Quantize = FMath::Max(GameplayRepGraph::SharedGatherLocationQuantize, 1.f);
+	return FIntVector(
+		FMath::FloorToInt(Viewer.ViewLocation.X / Quantize),
+		FMath::FloorToInt(Viewer.ViewLocation.Y / Quantize),
+		FMath::FloorToInt(Viewer.ViewLocation.Z / Quantize));
+}
+
+void UGameRepGraphNode_GridSpatialization2D::CopyGatheredLists(const FConnectionGatherActorListParameters& Params, EActorRepListTypeFlags Flags, int32 FirstListIdx, FActorRepListRefView& OutActors, TSet<AActor*>& CopiedActors)
+{
+	const auto& GatheredLists = Params.OutGatheredReplicationLists.GetLists(Flags);
+	for (int32 ListIdx = FirstListIdx; ListIdx < GatheredLists.Num(); ++ListIdx)
+	{
+		for (FActorRepListType Actor : GatheredLists[ListIdx])
+		{
+			// Actors overlapping several cells are in several lists
+			bool bAlreadyCopied = false;
+			CopiedActors.Add(Actor, &bAlreadyCopied);
+			if (!bAlreadyCopied)
+			{
+				OutActors.Add(Actor);
+			}
+		}
+	}
 }
 
+void UGameRepGraphNode_GridSpatialization2D::KeepCachedChannelsAlive(const FConnectionGatherActorListParameters& Params, const FActorRepListRefView& Actors, uint32 KeepAliveFrameNum)
+{
+	for (FActorRepListType Actor : Actors)
+	{
+		FConnectionReplicationActorInfo* ConnectionInfo = Params.ConnectionManager.ActorInfoMap.Find(Actor);
+		if (ConnectionInfo && ConnectionInfo->Channel)
+		{
+			ConnectionInfo->ActorChannelCloseFrameNum = FMath::Max<uint32>(ConnectionInfo->ActorChannelCloseFrameNum, KeepAliveFrameNum + ConnectionInfo->ActorChannelFrameTimeout);
+		}
+	}
+}
 
 // --------------------------------------------------------------------------------------------------------------------
-// UGameRepGraphNode_PlayerStateFrequencyLimiter
+// UGameRepGraphNode_ProjectileEvents
 // --------------------------------------------------------------------------------------------------------------------
 
-UGameRepGraphNode_PlayerStateFrequencyLimiter::UGameRepGraphNode_PlayerStateFrequencyLimiter()
+UGameRepGraphNode_ProjectileEvents::UGameRepGraphNode_ProjectileEvents()
 {
 	bRequiresPrepareForReplicationCall = true;
 }
 
-void UGameRepGraphNode_PlayerStateFrequencyLimiter::GatherActorListsForConnection(
-	const FConnectionGatherActorListParameters& Params)
+void UGameRepGraphNode_ProjectileEvents::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
 {
-	const int32 ListIdx = Params.ReplicationFrameNum % ReplicationActorLists.Num();
-	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorLists[ListIdx]);
+	if (!ActorInfo.Actor->Implements<UEventReplicatedProjectile>())
+	{
+		UE_LOG(LogGameRepGraph, Warning, TEXT("%s is routed to ProjectileEvents but doesn't implement IEventReplicatedProjectile, it won't replicate."), *GetNameSafe(ActorInfo.Actor));
+		return;
+	}
 
-	if (ForceNetUpdateReplicationActorList.Num() > 0)
+	FProjectileRecord& Record = Projectiles.Add(ActorInfo.Actor);
+	Record.ProjectileId = ++LastProjectileId;
+	Record.CullDistanceSquared = GraphGlobals->GlobalActorReplicationInfoMap->Get(ActorInfo.Actor).Settings.GetCullDistanceSquared();
+
+	// Spawn parameters are only read once the projectile finished spawning and got its velocity
+	NewProjectiles.Add(ActorInfo.Actor);
+}
+
+bool UGameRepGraphNode_ProjectileEvents::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	FProjectileRecord Record;
+	if (!Projectiles.RemoveAndCopyValue(ActorInfo.Actor, Record))
 	{
-		Params.OutGatheredReplicationLists.AddReplicationActorList(ForceNetUpdateReplicationActorList);
-	}	
+		return false;
+	}
+
+	if (!Record.bSpawnEventAdded)
+	{
+		// Gone before anyone heard of it
+		NewProjectiles.RemoveSwap(ActorInfo.Actor);
+		return true;
+	}
+
+	if (!Record.bImpactEventAdded)
+	{
+		// Destroyed without a reported impact (lifespan, out of bounds), clients still need to end their copy
+		FImpactEntry& Entry = PendingImpacts.AddDefaulted_GetRef();
+		Entry.Event.ProjectileId = Record.ProjectileId;
+		Entry.Event.Location = ActorInfo.Actor->GetActorLocation();
+		Entry.Event.bHit = false;
+		Entry.Origin = Record.Origin;
+		Entry.CullDistanceSquared = Record.CullDistanceSquared;
+	}
+
+	return true;
 }
 
-void UGameRepGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+void UGameRepGraphNode_ProjectileEvents::NotifyResetAllNetworkActors()
 {
-	ReplicationActorLists.Reset();
-	ForceNetUpdateReplicationActorList.Reset();
+	Projectiles.Reset();
+	NewProjectiles.Reset();
+	PendingSpawns.Reset();
+	PendingImpacts.Reset();
+	FrameSpawns.Reset();
+	FrameImpacts.Reset();
+	ConnectionEvents.Reset();
+}
 
-	ReplicationActorLists.AddDefaulted();
-	FActorRepListRefView* CurrentList = &ReplicationActorLists[0];
+void UGameRepGraphNode_ProjectileEvents::PrepareForReplication()
+{
+	for (AActor* Projectile : NewProjectiles)
+	{
+		AddSpawnEvent(Projectile);
+	}
 
-	// We rebuild our lists of player states each frame. This is not as efficient as it could be but its the simplest way
-	// to handle players disconnecting and keeping the lists compact. If the lists were persistent we would need to defrag them as players left.
-	for (TActorIterator<APlayerState> It(GetWorld()); It; ++It)
+	NewProjectiles.Reset();
+
+	// Last frame's events have been sent, every connection gets each event only once
+	Swap(FrameSpawns, PendingSpawns);
+	Swap(FrameImpacts, PendingImpacts);
+	PendingSpawns.Reset();
+	PendingImpacts.Reset();
+}
+
+void UGameRepGraphNode_ProjectileEvents::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	if (FrameSpawns.Num() == 0 && FrameImpacts.Num() == 0)
 	{
-		APlayerState* PS = *It;
-		if (IsActorValidForReplicationGather(PS) == false)
+		return;
+	}
+
+	UNetConnection* NetConnection = Params.ConnectionManager.NetConnection;
+	UProjectileEventComponent* EventComponent = UProjectileEventComponent::FindProjectileEventComponent(NetConnection ? NetConnection->PlayerController : nullptr);
+	if (EventComponent == nullptr)
+	{
+		return;
+	}
+
+	// Saturated connections see new projectiles only as far as their low priority actors
+	float SpawnCullDistanceScale = 1.f;
+	for (UReplicationGraphNode* ConnectionNode : Params.ConnectionManager.GetConnectionGraphNodes())
+	{
+		if (const UGameRepGraphNode_ActorPolicy_ForConnection* ActorPolicyNode = Cast<UGameRepGraphNode_ActorPolicy_ForConnection>(ConnectionNode))
+		{
+			SpawnCullDistanceScale = ActorPolicyNode->GetSaturationCullDistanceScale();
+			break;
+		}
+	}
+
+	// Gathering the same connection twice in a frame replaces its events, so nothing is sent twice
+	FConnectionEvents& Events = ConnectionEvents.FindOrAdd(NetConnection);
+	Events.NetConnection = NetConnection;
+	Events.EventComponent = EventComponent;
+	Events.Spawns.Reset();
+	Events.Impacts.Reset();
+
+	for (const FSpawnEntry& Entry : FrameSpawns)
+	{
+		if (IsRelevantToViewers(Params, Entry.Event.Origin, Entry.Event.Origin, Entry.CullDistanceSquared * FMath::Square(SpawnCullDistanceScale)))
+		{
+			Events.Spawns.Add(Entry.Event);
+		}
+	}
+
+	// Connections that saw the projectile leave get its impact too, so their copy doesn't fly on
+	for (const FImpactEntry& Entry : FrameImpacts)
+	{
+		if (IsRelevantToViewers(Params, Entry.Origin, Entry.Event.Location, Entry.CullDistanceSquared))
+		{
+			Events.Impacts.Add(Entry.Event);
+		}
+	}
+
+	if (Events.Spawns.Num() == 0 && Events.Impacts.Num() == 0)
+	{
+		ConnectionEvents.Remove(NetConnection);
+	}
+}
+
+void UGameRepGraphNode_ProjectileEvents::FlushEvents()
+{
+	const int32 MaxEventsPerBatch = FMath::Max(GameplayRepGraph::ProjectileMaxEventsPerBatch, 1);
+
+	for (const auto& EventsIt : ConnectionEvents)
+	{
+		const FConnectionEvents& Events = EventsIt.Value;
+		UNetConnection* NetConnection = Events.NetConnection.Get();
+		UProjectileEventComponent* EventComponent = Events.EventComponent.Get();
+		if (NetConnection == nullptr || EventComponent == nullptr)
 		{
 			continue;
 		}
 
-		if (CurrentList->Num() >= TargetActorsPerFrame)
+		// The events are unreliable, a connection the actors just saturated would only drop them further down
+		if (!NetConnection->IsNetReady(false))
 		{
-			ReplicationActorLists.AddDefaulted();
-			CurrentList = &ReplicationActorLists.Last(); 
+			NumDroppedEvents += Events.Spawns.Num() + Events.Impacts.Num();
+			continue;
 		}
-		
-		CurrentList->Add(PS);
-	}	
+
+		// Spawns go out first, impacts fill up the remaining room, so every impact arrives after its spawn
+		int32 SpawnIdx = 0;
+		int32 ImpactIdx = 0;
+		while (SpawnIdx < Events.Spawns.Num() || ImpactIdx < Events.Impacts.Num())
+		{
+			const int32 NumSpawns = FMath::Min(Events.Spawns.Num() - SpawnIdx, MaxEventsPerBatch);
+			const int32 NumImpacts = FMath::Min(Events.Impacts.Num() - ImpactIdx, MaxEventsPerBatch - NumSpawns);
+
+			EventComponent->ClientReceiveProjectileEvents(
+				TArray<FProjectileSpawnEvent>(Events.Spawns.GetData() + SpawnIdx, NumSpawns),
+				TArray<FProjectileImpactEvent>(Events.Impacts.GetData() + ImpactIdx, NumImpacts));
+
+			SpawnIdx += NumSpawns;
+			ImpactIdx += NumImpacts;
+		}
+	}
+
+	ConnectionEvents.Reset();
 }
 
-void UGameRepGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplicationGraphDebugInfo& DebugInfo,
-	const FString& NodeName) const
+void UGameRepGraphNode_ProjectileEvents::LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const
 {
 	DebugInfo.Log(NodeName);
-	DebugInfo.PushIndent();	
+	DebugInfo.PushIndent();
+	DebugInfo.Log(FString::Printf(TEXT("Projectiles: %d"), Projectiles.Num()));
+	DebugInfo.Log(FString::Printf(TEXT("Spawn Events: %d"), FrameSpawns.Num()));
+	DebugInfo.Log(FString::Printf(TEXT("Impact Events: %d"), FrameImpacts.Num()));
+	DebugInfo.Log(FString::Printf(TEXT("Dropped Events: %d"), NumDroppedEvents));
+	DebugInfo.PopIndent();
+}
 
-	int32 i=0;
-	for (const FActorRepListRefView& List : ReplicationActorLists)
+void UGameRepGraphNode_ProjectileEvents::AddImpact(AActor* Projectile, const FHitResult& Hit)
+{
+	FProjectileRecord* Record = Projectiles.Find(Projectile);
+	if (Record == nullptr || Record->bImpactEventAdded)
 	{
-		LogActorRepList(DebugInfo, FString::Printf(TEXT("Bucket[%d]"), i++), List);
+		return;
 	}
 
-	DebugInfo.PopIndent();
+	if (!Record->bSpawnEventAdded)
+	{
+		// Hit something before its first replication frame, the spawn has to go out with the impact
+		AddSpawnEvent(Projectile);
+		NewProjectiles.RemoveSwap(Projectile);
+	}
+
+	Record->bImpactEventAdded = true;
+
+	FImpactEntry& Entry = PendingImpacts.AddDefaulted_GetRef();
+	Entry.Event.ProjectileId = Record->ProjectileId;
+	Entry.Event.Location = Hit.bBlockingHit ? Hit.ImpactPoint : Projectile->GetActorLocation();
+	Entry.Event.Normal = Hit.ImpactNormal;
+	Entry.Event.HitActor = Hit.GetActor();
+	Entry.Event.bHit = true;
+	Entry.Origin = Record->Origin;
+	Entry.CullDistanceSquared = Record->CullDistanceSquared;
+}
+
+void UGameRepGraphNode_ProjectileEvents::AddSpawnEvent(AActor* Projectile)
+{
+	FProjectileRecord* Record = Projectiles.Find(Projectile);
+	if (Record == nullptr || Record->bSpawnEventAdded)
+	{
+		return;
+	}
+
+	Record->bSpawnEventAdded = true;
+
+	FSpawnEntry& Entry = PendingSpawns.AddDefaulted_GetRef();
+	Entry.Event.ProjectileId = Record->ProjectileId;
+	Entry.Event.ProjectileClass = Projectile->GetClass();
+	Entry.CullDistanceSquared = Record->CullDistanceSquared;
+
+	FVector Origin;
+	FVector Velocity;
+	int32 Seed = 0;
+	CastChecked<IEventReplicatedProjectile>(Projectile)->GetProjectileSpawnParameters(Origin, Velocity, Seed);
+
+	Entry.Event.Origin = Origin;
+	Entry.Event.Velocity = Velocity;
+	Entry.Event.Seed = Seed;
+
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+	Entry.Event.ServerSpawnTime = GameState ? GameState->GetServerWorldTimeSeconds() : (World ? World->GetTimeSeconds() : 0.0);
+
+	Record->Origin = Origin;
+}
+
+bool UGameRepGraphNode_ProjectileEvents::IsRelevantToViewers(const FConnectionGatherActorListParameters& Params, const FVector& Origin, const FVector& Location, float CullDistanceSquared)
+{
+	// No cull distance means relevant everywhere, same as for spatialized actors
+	if (CullDistanceSquared <= 0.f)
+	{
+		return true;
+	}
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		if (FVector::DistSquared(Viewer.ViewLocation, Origin) <= CullDistanceSquared || FVector::DistSquared(Viewer.ViewLocation, Location) <= CullDistanceSquared)
+		{
+			return true;
+		}
+	}
+
+	return false;
 }
@@ -4,6 +4,8 @@
 #include "GameplayReplicationGraphSettings.h"
 
 #include "GameplayReplicationGraph.h"
+#include "GameplayReplayReplicationGraph.h"
+#include "Crowd/CrowdReplicationCell.h"
 #include "GameFramework/Character.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GameplayReplicationGraphSettings)
@@ -12,5 +14,11 @@ UGameplayReplicationGraphSettings::UGameplayReplicationGraphSettings()
 {
 	CategoryName = TEXT("Game");
 	DefaultReplicationGraphClass = UGameplayReplicationGraph::StaticClass();
+	ReplayReplicationGraphClass = UGameplayReplayReplicationGraph::StaticClass();
 	BasePawnClass = ACharacter::StaticClass();
+
+	// Crowd cells never move
+	FRepGraphActorClassSettings& CrowdCellSettings = ClassSettings.AddDefaulted_GetRef();
+	CrowdCellSettings.ActorClass = ACrowdReplicationCell::StaticClass();
+	CrowdCellSettings.ClassNodeMapping = EClassRepNodeMapping::Spatialize_Static;
 }
@@ -0,0 +1,100 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+
+#include "Projectiles/ProjectileEventComponent.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ProjectileEventComponent)
+
+UProjectileEventComponent::UProjectileEventComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetIsReplicatedByDefault(true);
+}
+
+void UProjectileEventComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (const auto& ProjectileIt : LocalProjectiles)
+	{
+		if (AActor* Projectile = ProjectileIt.Value.Get())
+		{
+			Projectile->Destroy();
+		}
+	}
+
+	LocalProjectiles.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+UProjectileEventComponent* UProjectileEventComponent::FindProjectileEventComponent(const APlayerController* PC)
+{
+	return PC ? PC->FindComponentByClass<UProjectileEventComponent>() : nullptr;
+}
+
+void UProjectileEventComponent::ClientReceiveProjectileEvents_Implementation(const TArray<FProjectileSpawnEvent>& SpawnEvents, const TArray<FProjectileImpactEvent>& ImpactEvents)
+{
+	// Drop the projectiles that ended on their own, e.g. because their impact event got lost
+	for (auto It = LocalProjectiles.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (const FProjectileSpawnEvent& SpawnEvent : SpawnEvents)
+	{
+		SpawnLocalProjectile(SpawnEvent);
+	}
+
+	for (const FProjectileImpactEvent& ImpactEvent : ImpactEvents)
+	{
+		ImpactLocalProjectile(ImpactEvent);
+	}
+}
+
+void UProjectileEventComponent::SpawnLocalProjectile(const FProjectileSpawnEvent& SpawnEvent)
+{
+	UWorld* World = GetWorld();
+	UClass* ProjectileClass = SpawnEvent.ProjectileClass;
+	if (World == nullptr || ProjectileClass == nullptr || !ProjectileClass->ImplementsInterface(UEventReplicatedProjectile::StaticClass()))
+	{
+		return;
+	}
+
+	const AGameStateBase* GameState = World->GetGameState();
+	const float TimeSinceSpawn = GameState ? FMath::Max(GameState->GetServerWorldTimeSeconds() - SpawnEvent.ServerSpawnTime, 0.0) : 0.f;
+
+	const FTransform SpawnTransform(SpawnEvent.Velocity.Rotation(), SpawnEvent.Origin);
+	AActor* Projectile = World->SpawnActorDeferred<AActor>(ProjectileClass, SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Projectile == nullptr)
+	{
+		return;
+	}
+
+	// Purely local, the server never replicates this projectile
+	Projectile->SetReplicates(false);
+
+	CastChecked<IEventReplicatedProjectile>(Projectile)->InitFromSpawnEvent(SpawnEvent, TimeSinceSpawn);
+	Projectile->FinishSpawning(SpawnTransform);
+
+	LocalProjectiles.Add(SpawnEvent.ProjectileId, Projectile);
+}
+
+void UProjectileEventComponent::ImpactLocalProjectile(const FProjectileImpactEvent& ImpactEvent)
+{
+	TWeakObjectPtr<AActor> Projectile;
+	if (!LocalProjectiles.RemoveAndCopyValue(ImpactEvent.ProjectileId, Projectile) || !Projectile.IsValid())
+	{
+		return;
+	}
+
+	CastChecked<IEventReplicatedProjectile>(Projectile.Get())->OnImpactEvent(ImpactEvent);
+	Projectile->Destroy();
+}
@@ -0,0 +1,136 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Net/Serialization/FastArraySerializer.h"
+
+#include "CrowdReplicationCell.generated.h"
+
+class ACrowdReplicationCell;
+struct FCrowdAgentArray;
+
+/** A lightweight crowd agent, replicated as part of the cell it's in instead of as its own actor. */
+USTRUCT(BlueprintType)
+struct FCrowdAgent : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	FCrowdAgent() = default;
+
+	FCrowdAgent(int32 InAgentId, const FVector& InLocation, float InYaw, uint8 InState)
+		: AgentId(InAgentId)
+		, Location(InLocation)
+		, Yaw(FRotator::CompressAxisToShort(InYaw))
+		, State(InState)
+	{
+	}
+
+	FORCEINLINE float GetYaw() const { return FRotator::DecompressAxisFromShort(Yaw); }
+
+	//~ Begin FFastArraySerializerItem Interface
+	void PostReplicatedAdd(const FCrowdAgentArray& InArraySerializer);
+	void PostReplicatedChange(const FCrowdAgentArray& InArraySerializer);
+	void PreReplicatedRemove(const FCrowdAgentArray& InArraySerializer);
+	//~ End FFastArraySerializerItem Interface
+
+public:
+	/** Unique id of the agent, stays the same while it moves between cells. */
+	UPROPERTY()
+	int32 AgentId = INDEX_NONE;
+
+	/** Location of the agent, quantized to whole centimeters. */
+	UPROPERTY()
+	FVector_NetQuantize Location = FVector::ZeroVector;
+
+	/** Compressed yaw of the agent. */
+	UPROPERTY()
+	uint16 Yaw = 0;
+
+	/** Game defined state of the agent (e.g. idle, walking, panicking), drives its animation on clients. */
+	UPROPERTY()
+	uint8 State = 0;
+};
+
+/** All agents of a cell. Only agents that changed are sent, as a delta. */
+USTRUCT()
+struct FCrowdAgentArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FCrowdAgent, FCrowdAgentArray>(Items, DeltaParms, *this);
+	}
+
+public:
+	UPROPERTY()
+	TArray<FCrowdAgent> Items;
+
+	/** The cell these agents belong to. */
+	UPROPERTY(NotReplicated)
+	TObjectPtr<ACrowdReplicationCell> OwnerCell;
+};
+
+template<>
+struct TStructOpsTypeTraits<FCrowdAgentArray> : public TStructOpsTypeTraitsBase2<FCrowdAgentArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnCrowdAgentEvent, ACrowdReplicationCell* /*Cell*/, const FCrowdAgent& /*Agent*/);
+
+/**
+ * Replicates the crowd agents of one grid cell of an ACrowdReplicationManager through a single actor channel.
+ * Cells are spatialized like any other actor, so each connection only receives the cells within their cull distance.
+ *
+ * Clients bind to the static agent events to spawn, move and remove the agents' visual representation.
+ * An agent moving to another cell is removed from one cell and added to the other, but the two cells replicate independently,
+ * so a client may get the add of the new cell before the remove of the old one. Handlers need to key agents by (Cell, AgentId),
+ * not by AgentId alone, otherwise the late remove of the old cell drops the agent that just arrived in the new one.
+ */
+UCLASS(NotPlaceable, Transient)
+class GAMEPLAYREPLICATION_API ACrowdReplicationCell : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ACrowdReplicationCell(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	//~ Begin AActor Interface
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End AActor Interface
+
+	/** Adds an agent to this cell. Server only. */
+	void AddAgent(const FCrowdAgent& Agent);
+
+	/** Updates an agent of this cell. Only marks it dirty if its replicated state actually changed. Server only. */
+	bool UpdateAgent(int32 AgentId, const FVector& Location, float Yaw, uint8 State);
+
+	/** Removes an agent from this cell, returning its last state. Server only. */
+	bool RemoveAgent(int32 AgentId, FCrowdAgent* OutAgent = nullptr);
+
+	/** Returns the agent with the given id, if it's in this cell. Constant time on the server, a linear search on clients. */
+	const FCrowdAgent* FindAgent(int32 AgentId) const;
+
+	/** Returns how many agents are in this cell. */
+	int32 GetNumAgents() const { return Agents.Items.Num(); }
+
+public:
+	/** Called on clients whenever an agent enters relevancy, changes or leaves relevancy. The same agent may be in two cells for a moment. */
+	static FOnCrowdAgentEvent OnAgentAdded;
+	static FOnCrowdAgentEvent OnAgentChanged;
+	static FOnCrowdAgentEvent OnAgentRemoved;
+
+private:
+	UPROPERTY(Replicated)
+	FCrowdAgentArray Agents;
+
+	/** Index of each agent in Agents.Items, by AgentId. Server only, clients receive the items in whatever order the fast array applies them. */
+	TMap<int32, int32> AgentIndices;
+};
@@ -0,0 +1,96 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "CrowdReplicationManager.generated.h"
+
+class ACrowdReplicationCell;
+class UWorld;
+struct FCrowdAgent;
+
+/**
+ * Server side manager for large numbers of lightweight crowd agents (ambient NPCs, wildlife, ...).
+ * Instead of an actor and a channel per agent, agents are packed into one ACrowdReplicationCell per grid cell,
+ * which replicates them as a fast array, sending only agents that changed.
+ *
+ * Agents that need full gameplay (e.g. the player interacts with them) can be promoted to a regular actor and demoted again afterwards.
+ */
+UCLASS()
+class GAMEPLAYREPLICATION_API ACrowdReplicationManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ACrowdReplicationManager(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	/** Returns the crowd replication manager of the given world, if there is one. */
+	static ACrowdReplicationManager* Get(const UWorld* World);
+
+	/** Adds a new agent, returning its id. */
+	int32 AddAgent(const FVector& Location, float Yaw, uint8 State = 0);
+
+	/** Updates the replicated state of an agent, moving it to another cell if needed (see ACrowdReplicationCell about the order clients see the move in). */
+	void UpdateAgent(int32 AgentId, const FVector& Location, float Yaw, uint8 State);
+
+	/** Removes an agent. */
+	void RemoveAgent(int32 AgentId);
+
+	/** Replaces an agent by a regular actor of the given class, spawned at the agent's location. The agent is removed. */
+	AActor* PromoteAgent(int32 AgentId, TSubclassOf<AActor> ActorClass);
+
+	/** Replaces a (previously promoted) actor by an agent at its location, returning the new agent's id. The actor is destroyed. */
+	int32 DemoteActor(AActor* Actor, uint8 State = 0);
+
+	/** Returns the agent with the given id. */
+	const FCrowdAgent* FindAgent(int32 AgentId) const;
+
+protected:
+	//~ Begin AActor Interface
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End AActor Interface
+
+	/** Returns the coordinates of the cell the given location is in. */
+	FIntPoint GetCellCoords(const FVector& Location) const;
+
+	/** Returns the cell at the given coordinates, spawning it if it doesn't exist yet. */
+	ACrowdReplicationCell* FindOrAddCell(const FIntPoint& CellCoords);
+
+	/** Destroys the cell at the given coordinates once its last agent left and it stayed empty for EmptyCellLifetime. */
+	void ConditionalRemoveCell(const FIntPoint& CellCoords);
+
+	/** Destroys the cells that stayed empty for EmptyCellLifetime. */
+	void RemoveEmptyCells();
+
+protected:
+	/** Size of a cell. Connections receive every cell within the cell class' NetCullDistance, which should be larger than this. */
+	UPROPERTY(EditAnywhere, Category = Crowd, meta = (ForceUnits = cm, ClampMin = 100))
+	float CellSize = 10000.f;
+
+	/** The cell class to spawn. */
+	UPROPERTY(EditAnywhere, Category = Crowd)
+	TSubclassOf<ACrowdReplicationCell> CellClass;
+
+	/**
+	 * How long an empty cell is kept before it's destroyed. Agents walking back and forth across a cell border
+	 * would otherwise destroy and respawn the cell, and with it its channel on every connection. 0 = destroy right away.
+	 */
+	UPROPERTY(EditAnywhere, Category = Crowd, meta = (ForceUnits = s, ClampMin = 0))
+	float EmptyCellLifetime = 5.f;
+
+	/** All cells that currently have agents. */
+	UPROPERTY(Transient)
+	TMap<FIntPoint, TObjectPtr<ACrowdReplicationCell>> Cells;
+
+	/** The cell each agent is in. */
+	TMap<int32, FIntPoint> AgentCells;
+
+	/** Cells without agents, mapped to the world time they became empty. */
+	TMap<FIntPoint, double> EmptyCells;
+
+	FTimerHandle RemoveEmptyCellsTimer;
+
+	int32 NextAgentId = 0;
+};
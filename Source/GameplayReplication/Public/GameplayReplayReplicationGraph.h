@@ -0,0 +1,56 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "GameplayReplicationGraph.h"
+
+#include "GameplayReplayReplicationGraph.generated.h"
+
+class UReplicationGraphNode_ActorListFrequencyBuckets;
+class UObject;
+
+/**
+ * Lightweight replication graph for replay recording net drivers.
+ * The recorder is treated as a single all-seeing viewer: spatialized and interest group actors skip the grid
+ * and are gathered from one frequency bucketed list (GameRepGraph.Replay.FrequencyBuckets), without cull distances
+ * or per-connection policies. Frames that take longer than GameRepGraph.Replay.MaxRecordMs are paid back
+ * by skipping the following recording frames.
+ */
+UCLASS(Transient, Config = Engine)
+class GAMEPLAYREPLICATION_API UGameplayReplayReplicationGraph : public UGameplayReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UReplicationGraph Interface
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* ConnectionManager) override;
+
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+	//~ End UReplicationGraph Interface
+
+protected:
+	//~ Begin UGameplayReplicationGraph Interface
+	virtual void InflateClassCullDistance(UClass* Class, FClassReplicationInfo& Info) override;
+	//~ End UGameplayReplicationGraph Interface
+
+	/** Returns true, if actors of the given mapping are recorded through ReplayActorsNode instead of their regular node. */
+	static bool IsRecordedByReplayNode(EClassRepNodeMapping Mapping)
+	{
+		// Projectile events need a receiving component, the replay records event replicated projectiles as regular actors
+		return IsSpatialized(Mapping) || Mapping == EClassRepNodeMapping::RelevantInterestGroup || Mapping == EClassRepNodeMapping::ProjectileEvents;
+	}
+
+public:
+	/** Every spatialized, interest group and event replicated projectile actor, recorded regardless of where it is. */
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_ActorListFrequencyBuckets> ReplayActorsNode;
+
+private:
+	/** How many recording frames are still skipped to pay back the last one. */
+	int32 NumFramesToSkip = 0;
+};
@@ -8,12 +8,17 @@
 #include "GameplayReplicationGraph.generated.h"
 
 class UReplicationGraphNode_ActorList;
-class UReplicationGraphNode_GridSpatialization2D;
+class UGameRepGraphNode_GridSpatialization2D;
 class AGameplayDebuggerCategoryReplicator;
+class UGameRepGraphNode_OwnerOnly_ForConnection;
+class UGameRepGraphNode_InterestGroups;
+class UGameRepGraphNode_ProjectileEvents;
 class APlayerController;
 class APawn;
 class UClass;
 class UObject;
+class ULevel;
+struct FHitResult;
 
 /**
  * Gameplay Replication Graph implementation.
@@ -35,6 +40,15 @@ public:
 
 	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
 	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+	virtual void ForceNetUpdate(AActor* Actor) override;
+	virtual void FlushNetDormancy(AActor* Actor, bool WasDormInitial) override;
+
+	virtual void TearDown() override;
 	//~ End UReplicationGraph Interface
 
 #if WITH_GAMEPLAY_DEBUGGER
@@ -43,6 +57,110 @@ public:
 
 	void PrintRepNodePolicies();
 
+	/**
+	 * Must be called whenever the owner of a replicated actor changes (e.g. a weapon being picked up), the graph isn't told about SetOwner.
+	 * Re-routes owner-only actors owned by this actor (directly or through a chain) to the node of their new owning connection,
+	 * and moves a dependent actor over to its new owner. Only walks the actors owned by this actor, not every owner-only actor.
+	 * Possession changes of viewer pawns are detected automatically.
+	 */
+	void NotifyActorOwnerChanged(AActor* Actor);
+
+	/** Sets the owner of a replicated actor and notifies the graph of its net driver (see NotifyActorOwnerChanged). */
+	static void SetActorOwner(AActor* Actor, AActor* NewOwner);
+
+	/**
+	 * Publishes a replicated actor to a named interest group (e.g. a team marker to its team).
+	 * The actor will replicate to every connection subscribed to that group, no matter how it's routed otherwise.
+	 */
+	void AddActorToInterestGroup(AActor* Actor, FName GroupName);
+
+	/** Removes a replicated actor from a named interest group. */
+	void RemoveActorFromInterestGroup(AActor* Actor, FName GroupName);
+
+	/** Subscribes the connection of the given player controller to a named interest group. */
+	void SubscribeToInterestGroup(APlayerController* PC, FName GroupName);
+
+	/** Unsubscribes the connection of the given player controller from a named interest group. */
+	void UnsubscribeFromInterestGroup(APlayerController* PC, FName GroupName);
+
+	/**
+	 * Scales the cull distance of the given player's connection, e.g. while looking through a scope.
+	 * Only applies to classes with a MaxCullDistanceScale, and is clamped to it.
+	 */
+	void SetConnectionCullDistanceScale(APlayerController* PC, float CullDistanceScale);
+
+	/** Returns the LOD tier the actor was last gathered with for the given player's connection. 0 = full detail. */
+	int32 GetConnectionActorLODTier(APlayerController* PC, AActor* Actor);
+
+	/** Called by the connection managers whenever an actor channel opens or closes. */
+	void NotifyActorChannelOpened(const AActor* Actor);
+	void NotifyActorChannelClosed(const AActor* Actor);
+
+	/** Prints how many actor channels were opened and closed per class. */
+	void PrintChannelStats(bool bReset);
+
+	/** Prints the NetUpdateFrequency the adaptive frequency suggests per class, from the replication periods it settled on. */
+	void PrintAdaptiveFrequencies(bool bReset);
+
+	/**
+	 * Marks a replicated actor dirty, so it gets past GameRepGraph.SkipCleanActors on its next replication.
+	 * Classes with bReplicateOnlyWhenDirty need this called whenever they mark push-model properties dirty.
+	 */
+	static void MarkActorDirty(AActor* Actor);
+
+	/** Records that the actor changed this frame. */
+	void NotifyActorDirty(AActor* Actor);
+
+	/** Returns true, if the actor has been marked dirty in or after the given frame. */
+	bool IsActorDirtySince(AActor* Actor, uint32 FrameNum) const
+	{
+		const uint32* DirtyFrameNum = ActorDirtyFrames.Find(Actor);
+		return DirtyFrameNum && *DirtyFrameNum >= FrameNum;
+	}
+
+	/**
+	 * Reports the impact of an event replicated projectile (IEventReplicatedProjectile).
+	 * Clients get it along with the next frame's projectile events and end their copy of the projectile there.
+	 */
+	static void ReportProjectileImpact(AActor* Projectile, const FHitResult& Hit);
+
+	/** Records the impact of an event replicated projectile. */
+	void NotifyProjectileImpact(AActor* Projectile, const FHitResult& Hit);
+
+	/**
+	 * Deactivates a pooled actor instead of destroying it: hides it, disables its collision and tick and sends it dormant.
+	 * The actor stays registered with the graph, so no destruction info is sent and clients keep their copy.
+	 * Open channels go dormant once the hidden state has been replicated.
+	 */
+	static void DeactivatePooledActor(AActor* Actor);
+
+	/**
+	 * Reactivates a pooled actor at the given transform: moves it, shows it and wakes it up.
+	 * Connections that kept the actor reuse their dormant replicator, so only what changed since is sent instead of a full initial bunch.
+	 */
+	static void ActivatePooledActor(AActor* Actor, const FTransform& Transform);
+
+	/** Records whether a pooled actor is currently active. */
+	void NotifyPooledActorActive(AActor* Actor, bool bActive);
+
+	/** Returns true, if the actor is a deactivated pooled actor. */
+	bool IsPooledActorDeactivated(AActor* Actor) const { return DeactivatedPooledActors.Contains(Actor); }
+
+	/** Returns the replication policies of the given class. */
+	const FRepGraphClassPolicy* GetClassPolicy(UClass* Class) { return ClassPolicies.Get(Class); }
+
+	/** Returns how many classes have a per-frame budget (FRepGraphClassPolicy::BudgetIndex). */
+	int32 GetNumClassBudgets() const { return NumClassBudgets; }
+
+	/** Returns how many channels joining connections may still open this frame. */
+	int32 GetJoinChannelOpenBudget() const { return JoinChannelOpenBudget; }
+
+	/** Takes channel opens of a joining connection off this frame's shared budget. */
+	void ConsumeJoinChannelOpenBudget(int32 NumChannelOpens) { JoinChannelOpenBudget = FMath::Max(JoinChannelOpenBudget - NumChannelOpens, 0); }
+
+	/** Returns how much the governor currently scales distance band periods by. */
+	float GetGovernorPeriodScale() const { return GovernorPeriodScale; }
+
 public:
 	/** List of always relevant classes. */
 	UPROPERTY()
@@ -50,15 +168,37 @@ public:
 
 	/** Grid node to use for spatialization. */
 	UPROPERTY()
-	TObjectPtr<UReplicationGraphNode_GridSpatialization2D> GridNode;
+	TObjectPtr<UGameRepGraphNode_GridSpatialization2D> GridNode;
 
 	/** Node for always relevant actors. */
 	UPROPERTY()
 	TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
 
+	/** Node for actors published to interest groups. */
+	UPROPERTY()
+	TObjectPtr<UGameRepGraphNode_InterestGroups> InterestGroupNode;
+
+	/** Node for projectiles replicated as spawn and impact events. */
+	UPROPERTY()
+	TObjectPtr<UGameRepGraphNode_ProjectileEvents> ProjectileEventNode;
+
 	/** List of always relevant streaming level actors. */
 	TMap<FName, FActorRepListRefView> AlwaysRelevantStreamingLevelActors;
 
+	/** The frequency bucket nodes of the grid cells' dynamic actors. */
+	UPROPERTY()
+	TArray<TObjectPtr<UReplicationGraphNode_ActorListFrequencyBuckets>> DynamicBucketNodes;
+
+protected:
+	EClassRepNodeMapping GetMappingPolicy(UClass* Class);
+	static bool IsSpatialized(EClassRepNodeMapping Mapping) { return Mapping >= EClassRepNodeMapping::Spatialize_Static; }
+
+	/** Extends the cull distance of classes with cull distance policies, so the grid covers their largest per-connection cull distance. */
+	virtual void InflateClassCullDistance(UClass* Class, FClassReplicationInfo& Info);
+
+	/** Whether actors of classes with bAdaptiveFrequency get their replication period adapted by this graph. */
+	bool bAdaptiveFrequencies = true;
+
 private:
 	void AddClassRepInfo(UClass* Class, EClassRepNodeMapping Mapping);
 	void RegisterClassRepNodeMapping(UClass* Class);
@@ -68,12 +208,122 @@ private:
 	bool ConditionalInitClassReplicationInfo(UClass* Class, FClassReplicationInfo& ClassInfo);
 	void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool Spatialize) const;
 
-	EClassRepNodeMapping GetMappingPolicy(UClass* Class);
-	static bool IsSpatialized(EClassRepNodeMapping Mapping) { return Mapping >= EClassRepNodeMapping::Spatialize_Static; }
+	/** Returns the number of actors in the given level that are routed to the always relevant lists. */
+	int32 CountAlwaysRelevantActorsInLevel(const ULevel* Level);
+
+	/** Returns the connection manager of the connection that owns the given actor. */
+	UNetReplicationGraphConnection* FindConnectionManagerForActor(const AActor* Actor);
+
+	/** Returns the per-connection node of the given type for the connection that owns the given actor. */
+	template<typename NodeType>
+	NodeType* FindConnectionNodeForActor(const AActor* Actor);
+
+	/** Moves an owner-only actor to the node of its current owning connection. */
+	void UpdateOwnerOnlyActor(AActor* Actor, TWeakObjectPtr<UGameRepGraphNode_OwnerOnly_ForConnection>& InOutOwnerNode);
+
+	/** Moves the given actor and every owner-only actor it owns, directly or through a chain, to the node of their current owning connection. */
+	void UpdateOwnedOwnerOnlyActors(AActor* Actor);
+
+	/** Registers a dependent actor with its current owner, unregistering it from its previous one. Moves it to and from the grid while it has no owner. */
+	void UpdateDependentActor(AActor* Actor, TWeakObjectPtr<AActor>& InOutOwner);
+
+	/** Feeds the time of the last frame to the governor, stepping it up or down once per adjust interval. */
+	void UpdateGovernor(double FrameTimeMs);
+
+	/** Applies the frequency bucket count, distance band period scale and FastShared budget of the given governor level. */
+	void ApplyGovernorLevel(int32 NewLevel);
+
+	/** Once per adjust interval, moves the replication period of every adaptive actor towards how often it changed. */
+	void UpdateAdaptiveFrequencies();
 
 private:
 	TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
 
+	/**
+	 * Drops the always relevant actor list of a streaming level in one operation.
+	 * Following per-actor removals for that level skip the list entirely.
+	 * Only called once the first actor of a level that is being removed from the world is routed out, all others follow right after.
+	 */
+	void RemoveStreamingLevelActors(FName StreamingLevelName);
+
+	/** Streaming levels whose always relevant list has been dropped in bulk, mapped to how many of their actors still need to be routed out. */
+	TMap<FName, int32> RemovedStreamingLevels;
+
+	/** All owner-only actors and the node of their owning connection. Null, if the actor has no owning connection yet. */
+	TMap<AActor*, TWeakObjectPtr<UGameRepGraphNode_OwnerOnly_ForConnection>> OwnerOnlyActors;
+
+	/** All dependent actors and the owner they're registered as a dependent of. Explicitly null, if the actor has no owner and is spatialized instead. */
+	TMap<AActor*, TWeakObjectPtr<AActor>> DependentActors;
+
+	/** Interest group actors of a class are published to when routed to RelevantInterestGroup. */
+	TClassMap<FName> ClassInterestGroups;
+
+	/** Per-class replication policies, applied per connection by UGameRepGraphNode_ActorPolicy_ForConnection. */
+	TClassMap<FRepGraphClassPolicy> ClassPolicies;
+
+	/** How many classes have a per-frame budget. */
+	int32 NumClassBudgets = 0;
+
+	/** The frame each actor was last marked dirty. */
+	TMap<AActor*, uint32> ActorDirtyFrames;
+
+	/** Pooled actors that are currently deactivated. */
+	TSet<AActor*> DeactivatedPooledActors;
+
+	struct FAdaptiveActorState
+	{
+		/** The actor's changelist history at the start of the current interval. INDEX_NONE, until it has been observed once. */
+		int32 LastHistoryEnd = INDEX_NONE;
+
+		/** How often the actor's properties had been compared at the start of the current interval. */
+		int32 LastCompareIndex = 0;
+
+		uint32 ReplicationPeriodFrame = 1;
+	};
+
+	/** All actors of classes with an adaptive frequency. */
+	TMap<AActor*, FAdaptiveActorState> AdaptiveActors;
+
+	struct FAdaptiveClassStats
+	{
+		double ReplicationPeriodSum = 0.0;
+		int32 NumSamples = 0;
+	};
+
+	/** The replication periods the adaptive frequency came up with, per class. */
+	TMap<TObjectKey<UClass>, FAdaptiveClassStats> AdaptiveClassStats;
+
+	/** Frame number of the last adaptive frequency update. */
+	uint32 LastAdaptiveUpdateFrame = 0;
+
+	/** How many channels joining connections may still open this frame, shared between all of them. */
+	int32 JoinChannelOpenBudget = MAX_int32;
+
+	struct FChannelStats
+	{
+		int32 NumOpened = 0;
+		int32 NumClosed = 0;
+	};
+
+	/** How many actor channels were opened and closed per class, across all connections. */
+	TMap<TObjectKey<UClass>, FChannelStats> ClassChannelStats;
+
+	/** How far the governor has currently stepped down. 0 = no adjustments. */
+	int32 GovernorLevel = 0;
+
+	/** Frame time the governor accumulated in the current adjust interval. */
+	double GovernorAccumulatedMs = 0.0;
+	int32 GovernorNumFrames = 0;
+
+	/** How much distance band periods are currently scaled by. */
+	float GovernorPeriodScale = 1.f;
+
+	/** The FastShared bandwidth budget before the governor scales it. */
+	int32 BaseFastSharedMaxBitsPerFrame = 0;
+
+	/** Settings of the grid cells' dynamic actor frequency buckets, owned by this graph. */
+	UReplicationGraphNode_ActorListFrequencyBuckets::FSettings DynamicBucketSettings;
+
 	/** Classes that had their replication settings explicitly set by code in UGameplayReplicationGraph::InitGlobalActorClassSettings */
 	TArray<UClass*> ExplicitlySetClasses;
 };
@@ -0,0 +1,28 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+
+#include "GameplayReplicationGraphConnection.generated.h"
+
+class AActor;
+class UActorChannel;
+class UObject;
+
+/**
+ * Connection manager used by the Gameplay Replication Graph.
+ * Reports actor channel opens and closes to the graph, so they can be tracked per class (GameRepGraph.PrintChannelStats).
+ */
+UCLASS(Transient)
+class UGameplayReplicationGraphConnection : public UNetReplicationGraphConnection
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UReplicationConnectionDriver Interface
+	virtual void NotifyActorChannelAdded(AActor* Actor, UActorChannel* Channel) override;
+	virtual void NotifyActorChannelRemoved(AActor* Actor) override;
+	//~ End UReplicationConnectionDriver Interface
+};
@@ -33,6 +33,14 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = ReplicationGraph, meta = (MetaClass = "/Script/GameplayReplication.GameplayReplicationGraph"))
 	FSoftClassPath DefaultReplicationGraphClass;
 
+	/** Whether replay recording net drivers should use a replication graph instead of the legacy relevancy path. */
+	UPROPERTY(Config, EditAnywhere, Category = ReplicationGraph)
+	bool bEnableReplayReplicationGraph = true;
+
+	/** The replication graph to use for replay recording net drivers. */
+	UPROPERTY(Config, EditAnywhere, Category = ReplicationGraph, meta = (MetaClass = "/Script/GameplayReplication.GameplayReplayReplicationGraph", EditCondition = "bEnableReplayReplicationGraph"))
+	FSoftClassPath ReplayReplicationGraphClass;
+
 	/** List of custom settings for specific actor classes. */
 	UPROPERTY(Config, EditAnywhere, Category = ReplicationGraph)
 	TArray<FRepGraphActorClassSettings> ClassSettings;
@@ -73,6 +81,37 @@ public:
 	UPROPERTY(EditAnywhere, Category = SpatialGrid, meta = (ConsoleVariable = "GameRepGraph.DisableSpatialRebuilds"))
 	bool bDisableSpatialRebuilds = true;
 
+	/**
+	 * How many frames the spatial grid spreads full gathers of connections across. 1 = every connection every frame.
+	 * In between full gathers, connections only get their cached spatial actors for the FastShared path.
+	 */
+	UPROPERTY(EditAnywhere, Category = SpatialGrid, meta = (ConsoleVariable = "GameRepGraph.GatherTimeSlices"))
+	int32 GatherTimeSlices = 1;
+
+	/** Whether connections with the same viewer and visible levels (e.g. spectators of the same player) should share one spatial gather per frame. */
+	UPROPERTY(EditAnywhere, Category = SpatialGrid, meta = (ConsoleVariable = "GameRepGraph.SharedGather.Enable"))
+	bool bEnableSharedGather = true;
+
+	/** Size of the cells viewer locations are snapped to when grouping connections into cohorts. */
+	UPROPERTY(EditAnywhere, Category = SpatialGrid, meta = (ForceUnits = cm, ConsoleVariable = "GameRepGraph.SharedGather.LocationQuantize"))
+	float SharedGatherLocationQuantize = 100.f;
+
+	/** How often (in frames) every cohort member runs its own gather, so its per-connection dormancy state catches up. */
+	UPROPERTY(EditAnywhere, Category = SpatialGrid, meta = (ConsoleVariable = "GameRepGraph.SharedGather.RefreshFrames"))
+	int32 SharedGatherRefreshFrames = 30;
+
+	/** How many buckets the replay graph spreads recorded actors across. Each actor is recorded every N frames. */
+	UPROPERTY(EditAnywhere, Category = Replay, meta = (ConsoleVariable = "GameRepGraph.Replay.FrequencyBuckets"))
+	int32 ReplayFrequencyBuckets = 4;
+
+	/** How long recording a replay frame may take on average. Longer frames are paid back by skipping the following ones. 0 = unbounded. */
+	UPROPERTY(EditAnywhere, Category = Replay, meta = (ForceUnits = ms, ConsoleVariable = "GameRepGraph.Replay.MaxRecordMs"))
+	float ReplayMaxRecordMs = 1.f;
+
+	/** The most recording frames skipped in a row to pay back a long one. */
+	UPROPERTY(EditAnywhere, Category = Replay, meta = (ConsoleVariable = "GameRepGraph.Replay.MaxSkippedFrames"))
+	int32 ReplayMaxSkippedFrames = 4;
+
 	/**
 	 * How many buckets to spread dynamic, spatialized actors across.
 	 * High number = more buckets = smaller effective replication frequency.
@@ -80,4 +119,147 @@ public:
 	 */
 	UPROPERTY(EditAnywhere, Category = DynamicSpatialFrequency, meta = (ConsoleVariable = "GameRepGraph.DynamicActorFrequencyBuckets"))
 	int32 DynamicActorFrequencyBuckets = 3;
+
+	/** Whether classes with bEnableOcclusionCulling should replicate less often to viewers they're hidden from. */
+	UPROPERTY(EditAnywhere, Category = OcclusionCulling, meta = (ConsoleVariable = "GameRepGraph.Occlusion.Enable"))
+	bool bEnableOcclusionCulling = true;
+
+	/** How many frames an occlusion result is reused before the actor is traced again. */
+	UPROPERTY(EditAnywhere, Category = OcclusionCulling, meta = (ConsoleVariable = "GameRepGraph.Occlusion.CacheFrames"))
+	int32 OcclusionCacheFrames = 10;
+
+	/** The maximum number of occlusion traces started per connection per frame. */
+	UPROPERTY(EditAnywhere, Category = OcclusionCulling, meta = (ConsoleVariable = "GameRepGraph.Occlusion.MaxTracesPerFrame"))
+	int32 OcclusionMaxTracesPerFrame = 16;
+
+	/** Actors closer than this to the viewer are never considered occluded. */
+	UPROPERTY(EditAnywhere, Category = OcclusionCulling, meta = (ForceUnits = cm, ConsoleVariable = "GameRepGraph.Occlusion.MinDistance"))
+	float OcclusionMinDistance = 1500.f;
+
+	/** How many occluded results in a row are needed before an actor is treated as occluded. A visible result applies right away. */
+	UPROPERTY(EditAnywhere, Category = OcclusionCulling, meta = (ConsoleVariable = "GameRepGraph.Occlusion.ResultsRequired"))
+	int32 OcclusionResultsRequired = 2;
+
+	/** Whether classes with bEnableViewCone should replicate less often while they're outside of the viewer's view cone. */
+	UPROPERTY(EditAnywhere, Category = ViewCone, meta = (ConsoleVariable = "GameRepGraph.ViewCone.Enable"))
+	bool bEnableViewCone = true;
+
+	/** Actors closer than this to the viewer are always treated as being inside the view cone. */
+	UPROPERTY(EditAnywhere, Category = ViewCone, meta = (ForceUnits = cm, ConsoleVariable = "GameRepGraph.ViewCone.MinDistance"))
+	float ViewConeMinDistance = 1000.f;
+
+	/** Whether classes with distance bands should replicate at the rate of the band they're in. */
+	UPROPERTY(EditAnywhere, Category = DistanceBands, meta = (ConsoleVariable = "GameRepGraph.DistanceBands.Enable"))
+	bool bEnableDistanceBands = true;
+
+	/** Whether classes with LOD tiers should reduce the full property and FastShared rates of distant actors. */
+	UPROPERTY(EditAnywhere, Category = LOD, meta = (ConsoleVariable = "GameRepGraph.LOD.Enable"))
+	bool bEnableLODTiers = true;
+
+	/** Whether classes with bEnablePredictiveRelevancy should start replicating early when they're about to enter a viewer's cull distance. */
+	UPROPERTY(EditAnywhere, Category = PredictiveRelevancy, meta = (ConsoleVariable = "GameRepGraph.Predictive.Enable"))
+	bool bEnablePredictiveRelevancy = true;
+
+	/**
+	 * How many new actor channels a connection may open per frame. 0 = unlimited.
+	 * The rest is deferred to the following frames, ordered by NetPriority and distance to the viewer.
+	 */
+	UPROPERTY(EditAnywhere, Category = ChannelOpens, meta = (ConsoleVariable = "GameRepGraph.MaxChannelOpensPerFrame"))
+	int32 MaxChannelOpensPerFrame = 0;
+
+	/** Whether classes with bShrinkCullDistanceWhenSaturated should get a shorter cull distance on saturated connections. */
+	UPROPERTY(EditAnywhere, Category = Saturation, meta = (ConsoleVariable = "GameRepGraph.Saturation.Enable"))
+	bool bEnableSaturationCullDistance = true;
+
+	/** The smallest scale the cull distance of saturated connections shrinks down to. */
+	UPROPERTY(EditAnywhere, Category = Saturation, meta = (ConsoleVariable = "GameRepGraph.Saturation.MinCullDistanceScale"))
+	float SaturationMinCullDistanceScale = 0.5f;
+
+	/** How much the cull distance scale changes per step. */
+	UPROPERTY(EditAnywhere, Category = Saturation, meta = (ConsoleVariable = "GameRepGraph.Saturation.StepScale"))
+	float SaturationStepScale = 0.1f;
+
+	/** How many frames in a row a connection needs to be saturated before its cull distance shrinks another step. */
+	UPROPERTY(EditAnywhere, Category = Saturation, meta = (ConsoleVariable = "GameRepGraph.Saturation.ShrinkFrames"))
+	int32 SaturationShrinkFrames = 4;
+
+	/** How many frames in a row a connection needs to be clear before its cull distance recovers a step. Should be well above ShrinkFrames. */
+	UPROPERTY(EditAnywhere, Category = Saturation, meta = (ConsoleVariable = "GameRepGraph.Saturation.RecoverFrames"))
+	int32 SaturationRecoverFrames = 30;
+
+	/** Whether joining connections should get their actors in stages, essentials and nearby actors first. */
+	UPROPERTY(EditAnywhere, Category = JoinStaging, meta = (ConsoleVariable = "GameRepGraph.Join.Enable"))
+	bool bEnableJoinStaging = false;
+
+	/** How many frames after joining a connection ramps up to its full set of actors. */
+	UPROPERTY(EditAnywhere, Category = JoinStaging, meta = (ConsoleVariable = "GameRepGraph.Join.RampFrames"))
+	int32 JoinRampFrames = 90;
+
+	/** Actors within this distance are sent to joining connections right away. The distance grows to unlimited over the ramp. */
+	UPROPERTY(EditAnywhere, Category = JoinStaging, meta = (ForceUnits = cm, ConsoleVariable = "GameRepGraph.Join.NearDistance"))
+	float JoinNearDistance = 5000.f;
+
+	/** How many actor channels all joining connections together may open per frame. 0 = only the per-connection limit applies. */
+	UPROPERTY(EditAnywhere, Category = JoinStaging, meta = (ConsoleVariable = "GameRepGraph.Join.MaxChannelOpensPerFrame"))
+	int32 JoinMaxChannelOpensPerFrame = 30;
+
+	/** Whether classes with MaxActorsPerFrame should be limited to that many actors per connection per frame. */
+	UPROPERTY(EditAnywhere, Category = ReplicationBudget, meta = (ConsoleVariable = "GameRepGraph.ClassBudgets.Enable"))
+	bool bEnableClassBudgets = true;
+
+	/** Whether classes with bReplicateOnlyWhenDirty should skip actors that haven't been marked dirty since they last replicated. */
+	UPROPERTY(EditAnywhere, Category = PushModel, meta = (ConsoleVariable = "GameRepGraph.SkipCleanActors"))
+	bool bSkipCleanActors = true;
+
+	/** Whether classes with bEnableAdaptiveFrequency should adapt the replication period of their actors to how often they change. */
+	UPROPERTY(EditAnywhere, Category = AdaptiveFrequency, meta = (ConsoleVariable = "GameRepGraph.Adaptive.Enable"))
+	bool bEnableAdaptiveFrequency = true;
+
+	/** How many frames the adaptive frequency observes actors for before adjusting their replication period. */
+	UPROPERTY(EditAnywhere, Category = AdaptiveFrequency, meta = (ConsoleVariable = "GameRepGraph.Adaptive.IntervalFrames"))
+	int32 AdaptiveIntervalFrames = 60;
+
+	/** Actors whose replications carried changed data at most this often get their replication period doubled. */
+	UPROPERTY(EditAnywhere, Category = AdaptiveFrequency, meta = (ClampMin = 0, ClampMax = 1, ConsoleVariable = "GameRepGraph.Adaptive.LowChangePct"))
+	float AdaptiveLowChangePct = 0.25f;
+
+	/** Actors whose replications carried changed data at least this often get their replication period halved. */
+	UPROPERTY(EditAnywhere, Category = AdaptiveFrequency, meta = (ClampMin = 0, ConsoleVariable = "GameRepGraph.Adaptive.HighChangePct"))
+	float AdaptiveHighChangePct = 0.9f;
+
+	/** The most projectile events sent to a connection in a single RPC. Larger batches are split across multiple RPCs. */
+	UPROPERTY(EditAnywhere, Category = Projectiles, meta = (ClampMin = 1, ConsoleVariable = "GameRepGraph.Projectiles.MaxEventsPerBatch"))
+	int32 ProjectileMaxEventsPerBatch = 32;
+
+	/** Whether the replication graph should scale its work down while it takes longer than the target frame time. */
+	UPROPERTY(EditAnywhere, Category = Governor, meta = (ConsoleVariable = "GameRepGraph.Governor.Enable"))
+	bool bEnableGovernor = false;
+
+	/** How long replicating actors may take per frame, averaged over the adjust interval. */
+	UPROPERTY(EditAnywhere, Category = Governor, meta = (ForceUnits = ms, ConsoleVariable = "GameRepGraph.Governor.TargetMs"))
+	float GovernorTargetMs = 4.f;
+
+	/** How many frames the governor averages over before adjusting. */
+	UPROPERTY(EditAnywhere, Category = Governor, meta = (ConsoleVariable = "GameRepGraph.Governor.AdjustIntervalFrames"))
+	int32 GovernorAdjustIntervalFrames = 30;
+
+	/** How many levels the governor may step down in. Its bounds below are reached at the last level. */
+	UPROPERTY(EditAnywhere, Category = Governor, meta = (ConsoleVariable = "GameRepGraph.Governor.MaxLevel"))
+	int32 GovernorMaxLevel = 4;
+
+	/** The governor steps back up once the average frame time is below this percentage of the target. */
+	UPROPERTY(EditAnywhere, Category = Governor, meta = (ConsoleVariable = "GameRepGraph.Governor.RecoveryPct"))
+	float GovernorRecoveryPct = 0.75f;
+
+	/** The most dynamic actor frequency buckets the governor may use. */
+	UPROPERTY(EditAnywhere, Category = Governor, meta = (ConsoleVariable = "GameRepGraph.Governor.MaxFrequencyBuckets"))
+	int32 GovernorMaxFrequencyBuckets = 6;
+
+	/** The most the governor may scale distance band periods by. */
+	UPROPERTY(EditAnywhere, Category = Governor, meta = (ConsoleVariable = "GameRepGraph.Governor.MaxPeriodScale"))
+	float GovernorMaxPeriodScale = 2.f;
+
+	/** The lowest percentage of the FastShared bandwidth budget the governor may go down to. */
+	UPROPERTY(EditAnywhere, Category = Governor, meta = (ConsoleVariable = "GameRepGraph.Governor.MinFastSharedPct"))
+	float GovernorMinFastSharedPct = 0.5f;
 };
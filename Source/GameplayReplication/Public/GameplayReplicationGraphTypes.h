@@ -17,6 +17,10 @@ DECLARE_LOG_CATEGORY_EXTERN(LogGameRepGraph, Display, All);
  *
  * – Not Routed
  * – Relevant All Connections
+ * – Relevant Owner Only
+ * – Dependent On Owner
+ * – Relevant Interest Group
+ * – Projectile Events
  * – Spatialize Static
  * – Spatialize Dynamic
  * – Spatialize Dormancy
@@ -36,6 +40,35 @@ enum class EClassRepNodeMapping : uint8
 	 */
 	RelevantAllConnections,
 
+	/**
+	 * Routes to the UGameRepGraphNode_OwnerOnly_ForConnection node of the owning connection.
+	 * Used for bOnlyRelevantToOwner actors, these are only gathered for their owner.
+	 * Owner changes need to go through UGameplayReplicationGraph::SetActorOwner or NotifyActorOwnerChanged, otherwise the actor keeps replicating to its old owner.
+	 */
+	RelevantOwnerOnly,
+
+	/**
+	 * Registered as a dependent actor of its owner's replication entry.
+	 * Used for bNetUseOwnerRelevancy actors (attached weapons, cosmetics),
+	 * these replicate whenever their owner does without any spatial or relevancy checks of their own.
+	 * While they have no owner, they're spatialized as dynamic actors instead, so they still replicate.
+	 */
+	DependentOnOwner,
+
+	/**
+	 * Routes to the InterestGroupNode:
+	 * These actors only replicate to connections subscribed to an interest group they're published to (teams, squads, parties).
+	 * Actors are published to the class' InterestGroup setting, or from gameplay code (UGameplayReplicationGraph::AddActorToInterestGroup).
+	 */
+	RelevantInterestGroup,
+
+	/**
+	 * Routes to the ProjectileEventNode:
+	 * These actors never open a channel, nearby connections get their spawn parameters and impact as batched events instead.
+	 * Classes implementing IEventReplicatedProjectile are mapped here automatically.
+	 */
+	ProjectileEvents,
+
 	/** ONLY SPATIALIZED Enums below here! See UGameplayReplicationGraph::IsSpatialized */
 
 	/**
@@ -59,6 +92,46 @@ enum class EClassRepNodeMapping : uint8
 	Spatialize_Dormancy,
 };
 
+/**
+ * A distance band of a class' replication rate.
+ * Actors closer to the viewer than MaxDistance replicate every ReplicationPeriodFrame frames.
+ */
+USTRUCT()
+struct FRepGraphDistanceBand
+{
+	GENERATED_BODY()
+
+	/** Actors closer to the viewer than this use this band. */
+	UPROPERTY(EditAnywhere, Category = DistanceBand, meta = (ForceUnits = cm, ClampMin = 0))
+	float MaxDistance = 2000.f;
+
+	/** How often actors within this band replicate, in frames. */
+	UPROPERTY(EditAnywhere, Category = DistanceBand, meta = (ClampMin = 1))
+	int32 ReplicationPeriodFrame = 1;
+};
+
+/**
+ * A replication LOD tier of a class, used for actors at least MinDistance away from the viewer.
+ * Distant actors only get their full property set every so often, while their movement keeps going out through the FastShared path.
+ */
+USTRUCT()
+struct FRepGraphLODTier
+{
+	GENERATED_BODY()
+
+	/** Actors at least this far from the viewer use this tier. */
+	UPROPERTY(EditAnywhere, Category = LOD, meta = (ForceUnits = cm, ClampMin = 0))
+	float MinDistance = 5000.f;
+
+	/** The shortest replication period (in frames) of the full property set within this tier. */
+	UPROPERTY(EditAnywhere, Category = LOD, meta = (ClampMin = 1))
+	int32 MinReplicationPeriodFrame = 4;
+
+	/** How often the FastShared movement update is sent within this tier, in frames. */
+	UPROPERTY(EditAnywhere, Category = LOD, meta = (ClampMin = 1, ClampMax = 65535))
+	int32 FastSharedReplicationPeriodFrame = 2;
+};
+
 /**
  * Actor class settings that can be assigned directly to a class.
  * Can also be mapped to a FRepGraphActorTemplateSettings.
@@ -112,6 +185,10 @@ public:
 	UPROPERTY(EditAnywhere, Category = ClassSettings, meta = (EditCondition = bAddClassRepInfoToMap))
 	EClassRepNodeMapping ClassNodeMapping = EClassRepNodeMapping::NotRouted;
 
+	/** The interest group actors of this class are published to when routed to RelevantInterestGroup. Leave empty to only publish them from gameplay code. */
+	UPROPERTY(EditAnywhere, Category = ClassSettings, meta = (EditCondition = "bAddClassRepInfoToMap && ClassNodeMapping == EClassRepNodeMapping::RelevantInterestGroup"))
+	FName InterestGroup;
+
 	/** Should we add this class to the RPC_Multicast_OpenChannelForClass map? */
 	UPROPERTY(EditAnywhere, Category = ClassSettings, meta = (InlineEditConditionToggle))
 	bool bAddToRPC_Multicast_OpenChannelForClassMap = false;
@@ -119,4 +196,284 @@ public:
 	/** If this is added to RPC_Multicast_OpenChannelForClass map, should we actually open a channel or not? */
 	UPROPERTY(EditAnywhere, Category = ClassSettings, meta = (EditCondition = bAddToRPC_Multicast_OpenChannelForClassMap))
 	bool bRPC_Multicast_OpenChannelForClass = true;
+
+	/** True, if actors of this class should replicate less often to viewers they're hidden from by level geometry. */
+	UPROPERTY(EditAnywhere, Category = OcclusionCulling)
+	bool bEnableOcclusionCulling = false;
+
+	/** How many times longer the replication period of an occluded actor is. */
+	UPROPERTY(EditAnywhere, Category = OcclusionCulling, meta = (EditCondition = bEnableOcclusionCulling, ClampMin = 1))
+	int32 OccludedReplicationPeriodScale = 4;
+
+	/** True, if actors of this class should replicate less often while they're outside of the viewer's view cone. */
+	UPROPERTY(EditAnywhere, Category = ViewCone)
+	bool bEnableViewCone = false;
+
+	/** Half angle of the view cone. Actors inside of it replicate at their normal rate. */
+	UPROPERTY(EditAnywhere, Category = ViewCone, meta = (EditCondition = bEnableViewCone, Units = Degrees, ClampMin = 0, ClampMax = 180))
+	float ViewConeHalfAngle = 60.f;
+
+	/** How many times longer the replication period of an actor right behind the viewer is. Scales down towards the edge of the view cone. */
+	UPROPERTY(EditAnywhere, Category = ViewCone, meta = (EditCondition = bEnableViewCone, ClampMin = 1))
+	int32 OffScreenReplicationPeriodScale = 3;
+
+	/** The longest replication period (in frames) the view cone may give an off-screen actor, so turning around never shows stale state. */
+	UPROPERTY(EditAnywhere, Category = ViewCone, meta = (EditCondition = bEnableViewCone, ClampMin = 1))
+	int32 OffScreenMaxReplicationPeriodFrame = 6;
+
+	/**
+	 * Replication periods by distance to the closest viewer, evaluated per connection.
+	 * These replace the period derived from NetUpdateFrequency, actors beyond the farthest band use its period.
+	 * Leave empty to replicate at the same rate at any distance.
+	 */
+	UPROPERTY(EditAnywhere, Category = DistanceBands)
+	TArray<FRepGraphDistanceBand> DistanceBands;
+
+	/**
+	 * Replication LOD tiers by distance to the closest viewer, evaluated per connection.
+	 * Actors closer than the nearest tier replicate at full detail.
+	 */
+	UPROPERTY(EditAnywhere, Category = LOD)
+	TArray<FRepGraphLODTier> LODTiers;
+
+	/**
+	 * The largest per-connection cull distance scale (e.g. a zoomed sniper scope) actors of this class respect.
+	 * The class' cull distance is scaled up by this so the grid covers it, connections that aren't zoomed in get it scaled back down.
+	 * Leave at 1 to ignore per-connection cull distance scales.
+	 */
+	UPROPERTY(EditAnywhere, Category = CullDistance, meta = (ClampMin = 1))
+	float MaxCullDistanceScale = 1.f;
+
+	/**
+	 * How much further than its cull distance an actor with an open channel stays relevant.
+	 * Keeps actors moving along the cull distance from closing and reopening their channel over and over.
+	 */
+	UPROPERTY(EditAnywhere, Category = CullDistance, meta = (ForceUnits = cm, ClampMin = 0))
+	float CullDistanceExitMargin = 0.f;
+
+	/**
+	 * True, if this is a low priority class whose cull distance shrinks for connections that are saturated.
+	 * Makes saturated connections drop far away actors of this class first, instead of leaving it to priority starvation.
+	 */
+	UPROPERTY(EditAnywhere, Category = CullDistance)
+	bool bShrinkCullDistanceWhenSaturated = false;
+
+	/** True, if actors of this class should start replicating early when they're about to enter a viewer's cull distance. */
+	UPROPERTY(EditAnywhere, Category = PredictiveRelevancy)
+	bool bEnablePredictiveRelevancy = false;
+
+	/** How far ahead viewer and actor motion is extrapolated. */
+	UPROPERTY(EditAnywhere, Category = PredictiveRelevancy, meta = (EditCondition = bEnablePredictiveRelevancy, ForceUnits = s, ClampMin = 0))
+	float PredictiveLookahead = 1.f;
+
+	/** How far beyond the cull distance actors may become relevant early. The class' cull distance is extended by this so the grid covers it. */
+	UPROPERTY(EditAnywhere, Category = PredictiveRelevancy, meta = (EditCondition = bEnablePredictiveRelevancy, ForceUnits = cm, ClampMin = 0))
+	float PredictiveMaxDistance = 2000.f;
+
+	/** The replication period (in frames) actors replicate at until they actually enter the cull distance. */
+	UPROPERTY(EditAnywhere, Category = PredictiveRelevancy, meta = (EditCondition = bEnablePredictiveRelevancy, ClampMin = 1))
+	int32 PredictiveReplicationPeriodFrame = 8;
+
+	/**
+	 * How many actors of this class (and its subclasses) may replicate to a connection per frame. 0 = unlimited.
+	 * The rest rolls over to the following frames, closest and most starved actors first.
+	 */
+	UPROPERTY(EditAnywhere, Category = ReplicationBudget, meta = (ClampMin = 0))
+	int32 MaxActorsPerFrame = 0;
+
+	/**
+	 * True, if actors of this class only replicate to a connection after they've been marked dirty (UGameplayReplicationGraph::MarkActorDirty).
+	 * Meant for classes that only use push-model properties, which need to mark the actor dirty along with their properties.
+	 * ForceNetUpdate and dormancy flushes mark the actor dirty automatically, actors without a channel always replicate.
+	 */
+	UPROPERTY(EditAnywhere, Category = PushModel)
+	bool bReplicateOnlyWhenDirty = false;
+
+	/**
+	 * True, if the replication period of each actor of this class should adapt to how often it actually changes.
+	 * Suggested NetUpdateFrequencies are printed with GameRepGraph.PrintAdaptiveFrequencies and when the graph shuts down.
+	 */
+	UPROPERTY(EditAnywhere, Category = AdaptiveFrequency)
+	bool bEnableAdaptiveFrequency = false;
+
+	/** The shortest replication period (in frames) the adaptive frequency may give an actor. */
+	UPROPERTY(EditAnywhere, Category = AdaptiveFrequency, meta = (EditCondition = bEnableAdaptiveFrequency, ClampMin = 1, ClampMax = 65535))
+	int32 AdaptiveMinReplicationPeriodFrame = 1;
+
+	/** The longest replication period (in frames) the adaptive frequency may give an actor. */
+	UPROPERTY(EditAnywhere, Category = AdaptiveFrequency, meta = (EditCondition = bEnableAdaptiveFrequency, ClampMin = 1, ClampMax = 65535))
+	int32 AdaptiveMaxReplicationPeriodFrame = 30;
+
+	/**
+	 * True, if actors of this class are reused through UGameplayReplicationGraph::DeactivatePooledActor and ActivatePooledActor instead of being destroyed.
+	 * Spatialized classes are routed as Spatialize_Dormancy, so deactivated (dormant) actors sit in the static grid.
+	 * Deactivated actors don't open channels to connections that haven't received them yet.
+	 */
+	UPROPERTY(EditAnywhere, Category = Pooling)
+	bool bPooledActors = false;
+};
+
+/**
+ * Per-class replication policies, built from FRepGraphActorClassSettings.
+ * These are applied per connection by UGameRepGraphNode_ActorPolicy_ForConnection.
+ */
+struct FRepGraphClassPolicy
+{
+	FRepGraphClassPolicy() = default;
+
+	explicit FRepGraphClassPolicy(const FRepGraphActorClassSettings& Settings)
+		: bOcclusionCulling(Settings.bEnableOcclusionCulling)
+		, OccludedReplicationPeriodScale(FMath::Max(Settings.OccludedReplicationPeriodScale, 1))
+		, bViewCone(Settings.bEnableViewCone)
+		, ViewConeCosHalfAngle(FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(Settings.ViewConeHalfAngle, 0.f, 180.f))))
+		, OffScreenReplicationPeriodScale(FMath::Max(Settings.OffScreenReplicationPeriodScale, 1))
+		, OffScreenMaxReplicationPeriodFrame(FMath::Max(Settings.OffScreenMaxReplicationPeriodFrame, 1))
+		, MaxCullDistanceScale(FMath::Max(Settings.MaxCullDistanceScale, 1.f))
+		, CullDistanceExitMargin(FMath::Max(Settings.CullDistanceExitMargin, 0.f))
+		, bShrinkCullDistanceWhenSaturated(Settings.bShrinkCullDistanceWhenSaturated)
+		, bPredictiveRelevancy(Settings.bEnablePredictiveRelevancy)
+		, PredictiveLookahead(FMath::Max(Settings.PredictiveLookahead, 0.f))
+		, PredictiveMaxDistance(Settings.bEnablePredictiveRelevancy ? FMath::Max(Settings.PredictiveMaxDistance, 0.f) : 0.f)
+		, PredictiveReplicationPeriodFrame(FMath::Max(Settings.PredictiveReplicationPeriodFrame, 1))
+		, MaxActorsPerFrame(FMath::Max(Settings.MaxActorsPerFrame, 0))
+		, bReplicateOnlyWhenDirty(Settings.bReplicateOnlyWhenDirty)
+		, bAdaptiveFrequency(Settings.bEnableAdaptiveFrequency)
+		, AdaptiveMinReplicationPeriodFrame((uint32)FMath::Clamp(Settings.AdaptiveMinReplicationPeriodFrame, 1, MAX_uint16))
+		, AdaptiveMaxReplicationPeriodFrame((uint32)FMath::Clamp(Settings.AdaptiveMaxReplicationPeriodFrame, Settings.AdaptiveMinReplicationPeriodFrame, MAX_uint16))
+		, bPooledActors(Settings.bPooledActors)
+	{
+		for (const FRepGraphDistanceBand& Band : Settings.DistanceBands)
+		{
+			DistanceBands.Add({ FMath::Square(FMath::Max(Band.MaxDistance, 0.f)), (uint32)FMath::Max(Band.ReplicationPeriodFrame, 1) });
+		}
+
+		DistanceBands.Sort([](const FDistanceBand& A, const FDistanceBand& B) { return A.MaxDistanceSq < B.MaxDistanceSq; });
+
+		for (const FRepGraphLODTier& Tier : Settings.LODTiers)
+		{
+			LODTiers.Add({ FMath::Square(FMath::Max(Tier.MinDistance, 0.f)), (uint32)FMath::Max(Tier.MinReplicationPeriodFrame, 1), (uint16)FMath::Clamp(Tier.FastSharedReplicationPeriodFrame, 1, MAX_uint16) });
+		}
+
+		LODTiers.Sort([](const FLODTier& A, const FLODTier& B) { return A.MinDistanceSq < B.MinDistanceSq; });
+	}
+
+	/** True, if any per-connection policy applies to this class. */
+	FORCEINLINE bool HasConnectionPolicies() const
+	{
+		return bOcclusionCulling || bViewCone || DistanceBands.Num() > 0 || LODTiers.Num() > 0 || HasCullDistancePolicies() || BudgetIndex != INDEX_NONE || bReplicateOnlyWhenDirty || bPooledActors;
+	}
+
+	/** True, if the class' global cull distance is extended and needs to be brought back down per connection. */
+	FORCEINLINE bool HasCullDistancePolicies() const
+	{
+		return MaxCullDistanceScale > 1.f || CullDistanceExitMargin > 0.f || bShrinkCullDistanceWhenSaturated || bPredictiveRelevancy;
+	}
+
+	/** How far the class' global cull distance is extended beyond its (scaled) cull distance. */
+	FORCEINLINE float GetCullDistanceExtension() const
+	{
+		return FMath::Max(CullDistanceExitMargin, PredictiveMaxDistance);
+	}
+
+	/** Returns the replication period of the distance band the given distance falls into. */
+	uint32 GetDistanceBandPeriod(float DistanceSq) const
+	{
+		for (const FDistanceBand& Band : DistanceBands)
+		{
+			if (DistanceSq < Band.MaxDistanceSq)
+			{
+				return Band.ReplicationPeriodFrame;
+			}
+		}
+
+		return DistanceBands.Last().ReplicationPeriodFrame;
+	}
+
+	/** Returns the LOD tier the given distance falls into. 0 = full detail, N = LODTiers[N - 1]. */
+	int32 GetLODTier(float DistanceSq) const
+	{
+		int32 Tier = 0;
+		while (Tier < LODTiers.Num() && DistanceSq >= LODTiers[Tier].MinDistanceSq)
+		{
+			++Tier;
+		}
+
+		return Tier;
+	}
+
+public:
+	/** True, if occluded actors should replicate less often. */
+	bool bOcclusionCulling = false;
+
+	/** How many times longer the replication period of an occluded actor is. */
+	int32 OccludedReplicationPeriodScale = 1;
+
+	/** True, if actors outside of the viewer's view cone should replicate less often. */
+	bool bViewCone = false;
+
+	/** Cosine of the view cone's half angle. */
+	float ViewConeCosHalfAngle = 0.5f;
+
+	/** How many times longer the replication period of an actor right behind the viewer is. */
+	int32 OffScreenReplicationPeriodScale = 1;
+
+	/** The longest replication period the view cone may give an off-screen actor. */
+	int32 OffScreenMaxReplicationPeriodFrame = 1;
+
+	/** The largest per-connection cull distance scale. The class' global cull distance is already scaled by this. */
+	float MaxCullDistanceScale = 1.f;
+
+	/** How much further than its cull distance an actor with an open channel stays relevant. */
+	float CullDistanceExitMargin = 0.f;
+
+	/** True, if the cull distance shrinks for connections that are saturated. */
+	bool bShrinkCullDistanceWhenSaturated = false;
+
+	/** True, if actors about to enter a viewer's cull distance should start replicating early. */
+	bool bPredictiveRelevancy = false;
+
+	/** How far ahead viewer and actor motion is extrapolated, in seconds. */
+	float PredictiveLookahead = 0.f;
+
+	/** How far beyond the cull distance actors may become relevant early. */
+	float PredictiveMaxDistance = 0.f;
+
+	/** The replication period of actors that are only relevant because of the prediction. */
+	int32 PredictiveReplicationPeriodFrame = 1;
+
+	/** How many actors of this class may replicate to a connection per frame. 0 = unlimited. */
+	int32 MaxActorsPerFrame = 0;
+
+	/** Index of this class' per-frame budget, shared by its subclasses. INDEX_NONE if there is no budget. */
+	int32 BudgetIndex = INDEX_NONE;
+
+	/** True, if actors only replicate after they've been marked dirty. */
+	bool bReplicateOnlyWhenDirty = false;
+
+	/** True, if the replication period of each actor adapts to how often it changes, within the bounds below. */
+	bool bAdaptiveFrequency = false;
+	uint32 AdaptiveMinReplicationPeriodFrame = 1;
+	uint32 AdaptiveMaxReplicationPeriodFrame = 1;
+
+	/** True, if deactivated pooled actors of this class don't open new channels. */
+	bool bPooledActors = false;
+
+	struct FDistanceBand
+	{
+		float MaxDistanceSq;
+		uint32 ReplicationPeriodFrame;
+	};
+
+	/** Replication periods by distance to the closest viewer, sorted from near to far. */
+	TArray<FDistanceBand, TInlineAllocator<4>> DistanceBands;
+
+	struct FLODTier
+	{
+		float MinDistanceSq;
+		uint32 MinReplicationPeriodFrame;
+		uint16 FastSharedReplicationPeriodFrame;
+	};
+
+	/** Replication LOD tiers by distance to the closest viewer, sorted from near to far. */
+	TArray<FLODTier, TInlineAllocator<4>> LODTiers;
 };
\ No newline at end of file
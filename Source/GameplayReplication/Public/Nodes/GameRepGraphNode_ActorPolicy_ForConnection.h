@@ -0,0 +1,193 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "WorldCollision.h"
+
+#include "GameRepGraphNode_ActorPolicy_ForConnection.generated.h"
+
+struct FConnectionGatherActorListParameters;
+struct FConnectionReplicationActorInfo;
+struct FGlobalActorReplicationInfo;
+struct FNewReplicatedActorInfo;
+struct FRepGraphClassPolicy;
+class UGameplayReplicationGraph;
+class UObject;
+
+/**
+ * This node applies the per-class replication policies (FRepGraphClassPolicy) to the actors gathered for its connection.
+ * It doesn't gather any actors itself, it only adjusts the connection's actor infos and needs to be the last node of its connection.
+ *
+ * – Occlusion Culling: actors hidden from the viewer by level geometry replicate less often.
+ * – View Cone: actors outside of the viewer's view cone replicate less often.
+ * – Distance Bands: actors replicate at the rate of the distance band they're in, relative to the closest viewer.
+ * – LOD Tiers: distant actors get their full property set less often, and their FastShared movement at the tier's rate.
+ * – Cull Distance Scale: zoomed in connections see actors further away, everyone else keeps the class' base cull distance.
+ * – Cull Distance Exit Margin: actors with an open channel stay relevant a bit beyond their cull distance.
+ * – Saturation: low priority classes get a shorter cull distance while the connection is saturated, recovering once it's clear.
+ * – Predictive Relevancy: actors about to enter the cull distance start replicating early at a low rate.
+ * – Class Budgets: only so many actors of a class replicate per frame, the rest rolls over to the following frames.
+ * – Dirty Skipping: actors of push-model classes wait until they've been marked dirty since they last replicated.
+ * – Pooling: deactivated pooled actors don't open new channels.
+ *
+ * It also limits how many actor channels its connection opens per frame, for every gathered actor.
+ * Right after joining, the connection gets essentials and nearby actors first, the rest ramps up over GameRepGraph.Join.RampFrames.
+ */
+UCLASS()
+class UGameRepGraphNode_ActorPolicy_ForConnection : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UGameRepGraphNode_ActorPolicy_ForConnection();
+
+	//~ Begin UReplicationGraphNode Interface
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override { }
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+	//~ End UReplicationGraphNode Interface
+
+	/** Sets the cull distance scale of this connection. */
+	void SetCullDistanceScale(float InCullDistanceScale) { CullDistanceScale = FMath::Max(InCullDistanceScale, 1.f); }
+
+	/** Returns the cull distance scale of low priority classes, below 1 while the connection is saturated. */
+	float GetSaturationCullDistanceScale() const { return SaturationCullDistanceScale; }
+
+	/** Returns the LOD tier the actor was last gathered with for this connection. 0 = full detail. */
+	int32 GetActorLODTier(AActor* Actor) const
+	{
+		const FActorPolicyState* State = ActorStates.Find(Actor);
+		return State ? State->LODTier : 0;
+	}
+
+private:
+	/** Policy state of a single actor for this connection. */
+	struct FActorPolicyState
+	{
+		/** Last frame the policies were applied. Actors gathered through multiple lists are only handled once. */
+		uint32 LastAppliedFrame = 0;
+
+		/** The frame the last occlusion result expires and the actor gets traced again. */
+		uint32 OcclusionExpiryFrame = 0;
+
+		/** The occlusion trace in flight for this actor, 0 if there is none. */
+		uint32 PendingTraceId = 0;
+
+		/** How many occluded results we got in a row. */
+		uint8 NumOccludedResults = 0;
+
+		/** The LOD tier the actor was last gathered with. */
+		uint8 LODTier = 0;
+
+		/** True, if the actor is currently treated as occluded. */
+		bool bOccluded = false;
+	};
+
+	/** Applies all policies of the actor's class to the actor's info for this connection. */
+	void ApplyActorPolicies(const UGameplayReplicationGraph& GameGraph, const FConnectionGatherActorListParameters& Params, AActor* Actor, const FRepGraphClassPolicy& ClassPolicy, FActorPolicyState& State);
+
+	/** Returns true, if the actor should be treated as occluded. Starts a new async trace once the last result expired. */
+	bool UpdateOcclusion(const FConnectionGatherActorListParameters& Params, AActor* Actor, const FGlobalActorReplicationInfo& GlobalInfo, const FConnectionReplicationActorInfo& ConnectionInfo, FActorPolicyState& State);
+
+	void OnOcclusionTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Sets this connection's cull distance of the actor. Returns true, if the actor is only relevant because it's predicted to enter the cull distance. */
+	bool UpdateCullDistance(const FConnectionGatherActorListParameters& Params, AActor* Actor, const FRepGraphClassPolicy& ClassPolicy, const FGlobalActorReplicationInfo& GlobalInfo, FConnectionReplicationActorInfo& ConnectionInfo) const;
+
+	/** Shrinks or recovers the saturation cull distance scale, depending on how long the connection has been saturated or clear. */
+	void UpdateSaturation(const FConnectionGatherActorListParameters& Params);
+
+	/** Defers the actors of each class budget beyond its MaxActorsPerFrame to the next frame. */
+	void EnforceClassBudgets(const FConnectionGatherActorListParameters& Params);
+
+	/**
+	 * Defers the initial replication of gathered actors without a channel beyond GameRepGraph.MaxChannelOpensPerFrame to the next frame.
+	 * While joining, actors beyond the ramp distance are deferred as well and channel opens count against the shared join budget.
+	 */
+	void LimitChannelOpens(const FConnectionGatherActorListParameters& Params);
+
+	/**
+	 * Keeps an actor from replicating (and opening a channel) this frame, by giving it a tiny cull distance for this connection.
+	 * Unlike pushing its schedule, this also holds back actors with a pending ForceNetUpdate. Open channels are kept open.
+	 */
+	void DeferReplication(const FConnectionGatherActorListParameters& Params, AActor* Actor);
+
+	/** Gives the actors deferred last frame their cull distance back. */
+	void RestoreDeferredReplications(const FConnectionGatherActorListParameters& Params);
+
+	/**
+	 * Returns true, if the actor is one of the connection's own: its viewers, view targets, possessed pawns and player states.
+	 * These are managed by UGameRepGraphNode_AlwaysRelevant_ForConnection and keep their per-connection settings.
+	 */
+	static bool IsConnectionActor(const FConnectionGatherActorListParameters& Params, const AActor* Actor);
+
+	/** Returns the squared distance of the location to the closest viewer. */
+	static float GetClosestViewerDistanceSquared(const FConnectionGatherActorListParameters& Params, const FVector& Location);
+
+	/** Returns how far outside of the closest viewer's view cone the location is. 0 inside of the cone, 1 right behind the viewer. */
+	static float GetOffScreenFactor(const FConnectionGatherActorListParameters& Params, const FVector& Location, float CosHalfAngle);
+
+	/** Sets the replication period of an actor for this connection, rescheduling it if it's due sooner with the new period. */
+	static void SetReplicationPeriod(FConnectionReplicationActorInfo& ConnectionInfo, uint32 ReplicationPeriodFrame);
+
+	/** Sets the FastShared replication period of an actor for this connection, rescheduling it if it's due sooner with the new period. */
+	static void SetFastSharedReplicationPeriod(FConnectionReplicationActorInfo& ConnectionInfo, uint16 ReplicationPeriodFrame);
+
+private:
+	TMap<AActor*, FActorPolicyState> ActorStates;
+
+	/** Occlusion traces in flight, mapped to the actor they were started for. */
+	TMap<uint32, AActor*> PendingOcclusionTraces;
+
+	FTraceDelegate OcclusionTraceDelegate;
+	uint32 LastOcclusionTraceId = 0;
+
+	/** Frame number of the last gather, used to time occlusion results arriving in between. */
+	uint32 LastGatherFrame = 0;
+
+	/** How many occlusion traces we may still start this frame. */
+	int32 OcclusionTraceBudget = 0;
+
+	/** Cull distance scale of this connection, set from gameplay code (zoomed views). */
+	float CullDistanceScale = 1.f;
+
+	/** Cull distance scale of low priority classes, shrinks while the connection is saturated. */
+	float SaturationCullDistanceScale = 1.f;
+
+	/** How many frames in a row the connection has been saturated or clear. */
+	int32 NumSaturatedFrames = 0;
+	int32 NumClearFrames = 0;
+
+	/** How much the governor scales distance band periods by this frame. */
+	float DistanceBandPeriodScale = 1.f;
+
+	/** Scratch list of the actors that want to open a channel this frame, with their sort key. */
+	TArray<TPair<float, AActor*>> PendingChannelOpens;
+
+	/** How many channel opens were deferred last frame. */
+	int32 NumDeferredChannelOpens = 0;
+
+	/** Actors whose replication was deferred last frame, with the cull distance they had before. */
+	TMap<AActor*, float> DeferredReplications;
+
+	/** The frame this connection was first gathered for, its join ramp starts here. */
+	uint32 JoinFrame = 0;
+
+	/** The actors due to replicate this frame per class budget, with their sort key. */
+	struct FClassBudget
+	{
+		int32 MaxActorsPerFrame = 0;
+		TArray<TPair<float, AActor*>> Actors;
+	};
+
+	TArray<FClassBudget> ClassBudgets;
+
+	/** How many actors were deferred by class budgets last frame. */
+	int32 NumDeferredByClassBudgets = 0;
+};
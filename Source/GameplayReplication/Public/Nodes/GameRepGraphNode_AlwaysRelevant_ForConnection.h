@@ -40,6 +40,20 @@ public:
 #endif
 
 private:
+	/** Viewer state the cached relevant actors were last refreshed for. */
+	struct FCachedViewerState
+	{
+		TWeakObjectPtr<UNetConnection> Connection;
+		TWeakObjectPtr<AActor> Pawn;
+		TWeakObjectPtr<AActor> ViewTarget;
+	};
+
+	/** One entry per viewer of this connection. The cached relevant actors are only touched when one of these changes. */
+	TArray<FCachedViewerState, TInlineAllocator<2>> CachedViewerStates;
+
 	TArray<FName, TInlineAllocator<64>> AlwaysRelevantStreamingLevelsNeedingReplication;
 	bool bInitializedPlayerState = false;
+
+	/** True, if PastRelevantActorMap may contain stale connections and needs to be cleaned up. */
+	bool bCachedRelevantActorsDirty = false;
 };
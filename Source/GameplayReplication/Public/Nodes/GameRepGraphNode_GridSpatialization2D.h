@@ -0,0 +1,116 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+
+#include "GameRepGraphNode_GridSpatialization2D.generated.h"
+
+struct FConnectionGatherActorListParameters;
+struct FNetViewer;
+class UNetReplicationGraphConnection;
+class UObject;
+
+/**
+ * Spatial grid node that can time-slice its gather across connections (GameRepGraph.GatherTimeSlices).
+ * Each connection only gets a full gather every N frames, spread evenly by connection order.
+ * Full gathers keep the frequency bucket rotation. The slice phase of a connection shifts every NumSlices full gathers,
+ * so its slices never alias with the bucket count and no bucket is left out of its cycle.
+ * In between, the actors of its last full gather are only handed out for the FastShared path and their channels are kept open,
+ * so movement stays fresh while the full prioritization and replication of spatialized actors runs once per slice.
+ *
+ * Connections with the same viewer and visible levels (spectators and casters watching the same player) form a cohort,
+ * which shares a single gather per frame (GameRepGraph.SharedGather.Enable). Cohort members also share their time slice,
+ * so they run their full gathers on the same frame.
+ */
+UCLASS()
+class UGameRepGraphNode_GridSpatialization2D : public UReplicationGraphNode_GridSpatialization2D
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UReplicationGraphNode Interface
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+	//~ End UReplicationGraphNode Interface
+
+	/** Drops a removed actor from the cached and shared gathers. Needs to be called for every actor removed from the grid. */
+	void NotifyActorRemoved(AActor* Actor);
+
+	/** Drops the cached gather of a connection. */
+	void RemoveConnection(UNetReplicationGraphConnection* ConnectionManager);
+
+private:
+	struct FCachedGather
+	{
+		/** The actors gathered for the default and the FastShared path during the last full gather. Each actor is only in one of them. */
+		FActorRepListRefView DefaultActors;
+		FActorRepListRefView FastSharedActors;
+
+		uint32 LastFullGatherFrame = 0;
+
+		/** Whether the channels of the cached actors were already kept open until the next full gather. */
+		bool bChannelsKeptAlive = false;
+	};
+
+	struct FSharedGather
+	{
+		FActorRepListRefView DefaultActors;
+		FActorRepListRefView FastSharedActors;
+	};
+
+	/** Identifies a cohort. Connections only share a gather if all of it matches, the hash just speeds up the lookup. */
+	struct FCohortKey
+	{
+		TObjectKey<AActor> ViewTarget;
+
+		/** The viewer's location, snapped to GameRepGraph.SharedGather.LocationQuantize. */
+		FIntVector Location = FIntVector::ZeroValue;
+
+		/** The levels visible to the client, sorted. */
+		TArray<FName, TInlineAllocator<8>> VisibleLevels;
+
+		uint32 Hash = 0;
+
+		bool operator==(const FCohortKey& Other) const
+		{
+			return Hash == Other.Hash && ViewTarget == Other.ViewTarget && Location == Other.Location && VisibleLevels == Other.VisibleLevels;
+		}
+
+		friend uint32 GetTypeHash(const FCohortKey& Key) { return Key.Hash; }
+	};
+
+	/** Runs the grid gather, or reuses the one of this frame's cohort leader. Connections without a cohort always run their own. */
+	void GatherShared(const FConnectionGatherActorListParameters& Params, const FCohortKey* CohortKey);
+
+	/** Returns the cheap hash of the connection's cohort, built from its viewer and visible levels. Returns false, if the connection can't share its gather. */
+	static bool GetCohortHash(const FConnectionGatherActorListParameters& Params, uint32& OutCohortHash);
+
+	/** Builds the full cohort key of a connection, only needed once its cohort has more than one member. */
+	static void BuildCohortKey(const FConnectionGatherActorListParameters& Params, uint32 CohortHash, FCohortKey& OutCohortKey);
+
+	/** Returns the viewer's location, snapped to GameRepGraph.SharedGather.LocationQuantize. */
+	static FIntVector GetCohortLocation(const FNetViewer& Viewer);
+
+	/** Copies the actors of the lists added to the gathered lists since the given count, skipping the ones already in CopiedActors. */
+	static void CopyGatheredLists(const FConnectionGatherActorListParameters& Params, EActorRepListTypeFlags Flags, int32 FirstListIdx, FActorRepListRefView& OutActors, TSet<AActor*>& CopiedActors);
+
+	/** Pushes the channel timeout of the cached actors past the connection's next full gather. */
+	static void KeepCachedChannelsAlive(const FConnectionGatherActorListParameters& Params, const FActorRepListRefView& Actors, uint32 KeepAliveFrameNum);
+
+	TMap<TObjectKey<UNetReplicationGraphConnection>, FCachedGather> CachedGathers;
+
+	/** Actors removed within the last slices, mapped to the frame they were removed. Cached gathers may still reference them. */
+	TMap<TObjectKey<AActor>, uint32> RemovedActors;
+
+	/** This frame's gather of each cohort. */
+	TMap<FCohortKey, FSharedGather> SharedGathers;
+
+	/** How many connections were in each cohort this and last frame, by cohort hash. A hash collision only costs building the full keys. */
+	TMap<uint32, int32> CohortSizes;
+	TMap<uint32, int32> LastCohortSizes;
+
+	/** Frame number of the last gather. */
+	uint32 LastGatherFrame = 0;
+};
@@ -0,0 +1,62 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+
+#include "GameRepGraphNode_InterestGroups.generated.h"
+
+struct FConnectionGatherActorListParameters;
+struct FNewReplicatedActorInfo;
+class UObject;
+class UNetReplicationGraphConnection;
+
+/**
+ * This node replicates actors to the connections subscribed to the named interest groups they're published to.
+ * Useful for "always relevant to my team" actors such as team markers, pings or teammates across the map.
+ *
+ * Group membership and subscriptions are only changed by events, gathering is a list append per subscribed group.
+ */
+UCLASS()
+class UGameRepGraphNode_InterestGroups : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UReplicationGraphNode Interface
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override { }
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+	//~ End UReplicationGraphNode Interface
+
+	/** Publishes an actor to the given interest group. */
+	void AddActorToGroup(const FNewReplicatedActorInfo& ActorInfo, FName GroupName);
+
+	/** Removes an actor from the given interest group. */
+	void RemoveActorFromGroup(const FNewReplicatedActorInfo& ActorInfo, FName GroupName);
+
+	/** Subscribes a connection to the given interest group. */
+	void SubscribeConnection(UNetReplicationGraphConnection* ConnectionManager, FName GroupName);
+
+	/** Unsubscribes a connection from the given interest group. */
+	void UnsubscribeConnection(UNetReplicationGraphConnection* ConnectionManager, FName GroupName);
+
+	/** Drops every subscription of a connection. */
+	void RemoveConnection(UNetReplicationGraphConnection* ConnectionManager);
+
+private:
+	/** One actor list per interest group. These also take care of actors in streaming levels. */
+	UPROPERTY()
+	TMap<FName, TObjectPtr<UReplicationGraphNode_ActorList>> GroupNodes;
+
+	/** The groups each actor is published to. */
+	TMap<AActor*, TArray<FName, TInlineAllocator<2>>> ActorGroups;
+
+	/** The groups each connection is subscribed to. */
+	TMap<TObjectKey<UNetReplicationGraphConnection>, TArray<FName, TInlineAllocator<4>>> ConnectionSubscriptions;
+};
@@ -0,0 +1,21 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+
+#include "GameRepGraphNode_OwnerOnly_ForConnection.generated.h"
+
+class UObject;
+
+/**
+ * Per-connection node holding the bOnlyRelevantToOwner actors (weapons, inventory, owner-only HUD actors) owned by its connection.
+ * Actors are moved between connections by UGameplayReplicationGraph when their owner changes,
+ * so they're only ever gathered for their owner without any cross-connection relevancy tests.
+ */
+UCLASS()
+class UGameRepGraphNode_OwnerOnly_ForConnection : public UReplicationGraphNode_ActorList
+{
+	GENERATED_BODY()
+};
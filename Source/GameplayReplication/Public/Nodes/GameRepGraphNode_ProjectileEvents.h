@@ -0,0 +1,116 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "Projectiles/EventReplicatedProjectile.h"
+
+#include "GameRepGraphNode_ProjectileEvents.generated.h"
+
+struct FConnectionGatherActorListParameters;
+struct FHitResult;
+struct FNewReplicatedActorInfo;
+class UNetConnection;
+class UObject;
+class UProjectileEventComponent;
+
+/**
+ * This node replicates short-lived projectiles as events instead of actors (see IEventReplicatedProjectile).
+ * It never gathers any actors, so the projectiles don't open a channel to anyone.
+ *
+ * Once per frame, new projectiles are turned into spawn events and reported impacts into impact events.
+ * Every connection with a viewer within a projectile's cull distance of its origin (or impact) gets them in batched unreliable RPCs.
+ * Gathering only picks each connection's events, the RPCs go out in FlushEvents once the graph replicated its actors.
+ * Saturated connections get spawns only within their shrunk cull distance, and nothing at all while they aren't net ready.
+ * Projectiles destroyed without a reported impact send an expired impact event instead.
+ */
+UCLASS()
+class UGameRepGraphNode_ProjectileEvents : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UGameRepGraphNode_ProjectileEvents();
+
+	//~ Begin UReplicationGraphNode Interface
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+
+	virtual void PrepareForReplication() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	virtual void LogNode(FReplicationGraphDebugInfo& DebugInfo, const FString& NodeName) const override;
+	//~ End UReplicationGraphNode Interface
+
+	/** Records the impact of a projectile, it's sent along with the next frame's events. */
+	void AddImpact(AActor* Projectile, const FHitResult& Hit);
+
+	/** Sends the events gathered for each connection this frame. Called by the graph after ServerReplicateActors. */
+	void FlushEvents();
+
+private:
+	/** Turns a new projectile into its spawn event. Impacts reported before the next frame are always sent after it. */
+	void AddSpawnEvent(AActor* Projectile);
+
+	/** Returns true, if any viewer of the connection is within the cull distance of either location. */
+	static bool IsRelevantToViewers(const FConnectionGatherActorListParameters& Params, const FVector& Origin, const FVector& Location, float CullDistanceSquared);
+
+private:
+	struct FProjectileRecord
+	{
+		uint32 ProjectileId = 0;
+
+		/** Where the projectile was spawned, set once its spawn event was created. */
+		FVector Origin = FVector::ZeroVector;
+		float CullDistanceSquared = 0.f;
+
+		bool bSpawnEventAdded = false;
+		bool bImpactEventAdded = false;
+	};
+
+	/** All event replicated projectiles currently alive. */
+	TMap<AActor*, FProjectileRecord> Projectiles;
+
+	/** Projectiles that were added since the last frame and still need their spawn event. */
+	TArray<AActor*> NewProjectiles;
+
+	struct FSpawnEntry
+	{
+		FProjectileSpawnEvent Event;
+		float CullDistanceSquared = 0.f;
+	};
+
+	struct FImpactEntry
+	{
+		FProjectileImpactEvent Event;
+		FVector Origin = FVector::ZeroVector;
+		float CullDistanceSquared = 0.f;
+	};
+
+	/** Events added since the last frame. */
+	TArray<FSpawnEntry> PendingSpawns;
+	TArray<FImpactEntry> PendingImpacts;
+
+	/** The events sent to connections this frame. */
+	TArray<FSpawnEntry> FrameSpawns;
+	TArray<FImpactEntry> FrameImpacts;
+
+	struct FConnectionEvents
+	{
+		TWeakObjectPtr<UNetConnection> NetConnection;
+		TWeakObjectPtr<UProjectileEventComponent> EventComponent;
+
+		TArray<FProjectileSpawnEvent> Spawns;
+		TArray<FProjectileImpactEvent> Impacts;
+	};
+
+	/** The events gathered for each connection this frame, waiting for FlushEvents. */
+	TMap<TObjectKey<UNetConnection>, FConnectionEvents> ConnectionEvents;
+
+	uint32 LastProjectileId = 0;
+
+	/** How many events were dropped because their connection wasn't net ready. */
+	int32 NumDroppedEvents = 0;
+};
@@ -0,0 +1,100 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "UObject/Interface.h"
+
+#include "EventReplicatedProjectile.generated.h"
+
+class AActor;
+class UClass;
+
+/** Everything a client needs to simulate a projectile on its own, sent instead of replicating the projectile actor. */
+USTRUCT(BlueprintType)
+struct FProjectileSpawnEvent
+{
+	GENERATED_BODY()
+
+public:
+	/** Id of the projectile, matches its impact event. */
+	UPROPERTY()
+	uint32 ProjectileId = 0;
+
+	/** The class clients spawn their local copy of the projectile from. */
+	UPROPERTY()
+	TObjectPtr<UClass> ProjectileClass;
+
+	/** Where the projectile was spawned. */
+	UPROPERTY()
+	FVector_NetQuantize10 Origin = FVector::ZeroVector;
+
+	/** The initial velocity of the projectile. */
+	UPROPERTY()
+	FVector_NetQuantize10 Velocity = FVector::ZeroVector;
+
+	/** Seed of any randomness in the projectile's flight (spread, wobble), so clients simulate the same path. */
+	UPROPERTY()
+	int32 Seed = 0;
+
+	/** Server world time the projectile was spawned at, clients fast forward their simulation by how late they are. */
+	UPROPERTY()
+	double ServerSpawnTime = 0.0;
+};
+
+/** The end of a projectile's flight, either because it hit something or because it expired. */
+USTRUCT(BlueprintType)
+struct FProjectileImpactEvent
+{
+	GENERATED_BODY()
+
+public:
+	/** Id of the projectile, matches its spawn event. */
+	UPROPERTY()
+	uint32 ProjectileId = 0;
+
+	/** Where the projectile hit or expired. */
+	UPROPERTY()
+	FVector_NetQuantize Location = FVector::ZeroVector;
+
+	/** The surface normal of the hit. */
+	UPROPERTY()
+	FVector_NetQuantizeNormal Normal = FVector::ZeroVector;
+
+	/** The actor that was hit, if it's relevant to the client. */
+	UPROPERTY()
+	TObjectPtr<AActor> HitActor;
+
+	/** False, if the projectile was destroyed without hitting anything. */
+	UPROPERTY()
+	bool bHit = false;
+};
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UEventReplicatedProjectile : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Projectiles implementing this interface are routed to UGameRepGraphNode_ProjectileEvents instead of opening an actor channel.
+ * Nearby connections receive their spawn parameters in batched unreliable events through their UProjectileEventComponent,
+ * simulate the projectile deterministically and remove it once its impact event arrives.
+ *
+ * Gameplay code reports impacts through UGameplayReplicationGraph::ReportProjectileImpact.
+ */
+class GAMEPLAYREPLICATION_API IEventReplicatedProjectile
+{
+	GENERATED_BODY()
+
+public:
+	/** Server: returns the parameters clients simulate this projectile from. Called on the first replication frame after it was spawned. */
+	virtual void GetProjectileSpawnParameters(FVector& OutOrigin, FVector& OutVelocity, int32& OutSeed) const = 0;
+
+	/** Client: initializes the local simulation before the projectile finishes spawning. TimeSinceSpawn is how far behind the server it starts. */
+	virtual void InitFromSpawnEvent(const FProjectileSpawnEvent& SpawnEvent, float TimeSinceSpawn) = 0;
+
+	/** Client: the projectile hit something or expired on the server. It is destroyed right after. */
+	virtual void OnImpactEvent(const FProjectileImpactEvent& ImpactEvent) { }
+};
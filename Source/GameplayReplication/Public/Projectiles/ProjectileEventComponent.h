@@ -0,0 +1,52 @@
+// Copyright © 2024 Playton. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Projectiles/EventReplicatedProjectile.h"
+
+#include "ProjectileEventComponent.generated.h"
+
+class APlayerController;
+class AActor;
+
+/**
+ * Receives the projectile events of its connection and runs the local copies of event replicated projectiles.
+ * Needs to be added to the player controller, connections without one don't receive any projectile events.
+ *
+ * The events ride on the player controller's actor channel, so no projectile ever opens a channel of its own.
+ */
+UCLASS(ClassGroup = (Networking), meta = (BlueprintSpawnableComponent))
+class GAMEPLAYREPLICATION_API UProjectileEventComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UProjectileEventComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	//~ Begin UActorComponent Interface
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~ End UActorComponent Interface
+
+	/** Static function to get the projectile event component of a given player controller. */
+	static UProjectileEventComponent* FindProjectileEventComponent(const APlayerController* PC);
+
+	/** Sends a batch of projectile events to the owning client. Spawns are handled before impacts. */
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveProjectileEvents(const TArray<FProjectileSpawnEvent>& SpawnEvents, const TArray<FProjectileImpactEvent>& ImpactEvents);
+
+	/** Returns how many local projectiles are currently simulated. */
+	int32 GetNumLocalProjectiles() const { return LocalProjectiles.Num(); }
+
+private:
+	/** Spawns the local copy of a projectile and initializes its simulation. */
+	void SpawnLocalProjectile(const FProjectileSpawnEvent& SpawnEvent);
+
+	/** Ends the local copy of a projectile. */
+	void ImpactLocalProjectile(const FProjectileImpactEvent& ImpactEvent);
+
+private:
+	/** The local copies of the projectiles, by projectile id. Projectiles whose impact was lost are cleaned up once they destroy themselves. */
+	TMap<uint32, TWeakObjectPtr<AActor>> LocalProjectiles;
+};